@@ -0,0 +1,174 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FEATURE_BINNING_HPP_
+#define FEATURE_BINNING_HPP_
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <CGAL/number_utils.h>
+
+namespace geofis {
+
+/**
+ * The bin of a bounded feature: the id of the feature, the id of the site feature of its bin and the number of
+ * features in its bin.
+ */
+template <class Id> struct feature_bin {
+
+	feature_bin(const Id &id, const Id &bin_id, size_t bin_size) : id(id), bin_id(bin_id), bin_size(bin_size) {}
+
+	Id id;
+	Id bin_id;
+	size_t bin_size;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct feature_bin_cell_hash {
+
+	size_t operator()(const std::pair<int64_t, int64_t> &cell) const {
+		size_t hash = std::hash<int64_t>()(cell.first);
+		return hash ^ (std::hash<int64_t>()(cell.second) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+
+@startuml
+
+start
+
+while(feature ?) is (true)
+	:find the cell of the feature location with **binning**;
+	if(first feature of the cell ?) then (true)
+		:create a bin;
+	endif
+	:add the location and the attributes of the feature to its bin;
+	:store the bin index of the feature in **feature_bins**;
+endwhile (false)
+
+while(bin ?) is (true)
+	:find the feature of the bin closest to the mean location of the bin;
+	:copy a site feature with the id and the location of the closest feature and the mean attributes of the bin to **site_features**;
+endwhile (false)
+
+end
+
+@enduml
+
+*/
+
+/**
+ * Bins the features into the cells of the binning, each occupied cell giving one site feature: the feature of the
+ * cell closest to the mean location of the cell, with the mean attributes of the features of the cell. The site
+ * feature keeps the id and the location of a feature of the cell, it is inside the border whatever the shape of the
+ * border, and the site features are distinct when the features are. The bins are ordered by their first feature, the
+ * bin index of each feature is stored in feature_bins and the number of features of each bin in bin_sizes.
+ */
+template <class FeatureRange, class Binning, class FeatureContainer> void bin_features(const FeatureRange &features, const Binning &binning, FeatureContainer &site_features, std::vector<size_t> &feature_bins, std::vector<size_t> &bin_sizes) {
+
+	typedef typename boost::range_value<FeatureRange>::type feature_type;
+	typedef typename Binning::cell_type cell_type;
+
+	struct bin_accumulator {
+		double x;
+		double y;
+		std::vector<double> attributes;
+	};
+
+	std::unordered_map<cell_type, size_t, feature_bin_cell_hash> cell_bins;
+	std::vector<bin_accumulator> bins;
+	feature_bins.clear();
+	feature_bins.reserve(boost::size(features));
+	bin_sizes.clear();
+	for(const feature_type &feature : features) {
+		double x = CGAL::to_double(feature.get_geometry().x());
+		double y = CGAL::to_double(feature.get_geometry().y());
+		auto cell_bin = cell_bins.emplace(binning.get_cell(x, y), bins.size());
+		if(cell_bin.second) {
+			bins.push_back(bin_accumulator{0, 0, std::vector<double>(feature.get_attribute_size(), 0)});
+			bin_sizes.push_back(0);
+		}
+		size_t bin = cell_bin.first->second;
+		bin_accumulator &accumulator = bins[bin];
+		accumulator.x += x;
+		accumulator.y += y;
+		size_t attribute_index = 0;
+		for(double attribute : feature.get_attribute_range())
+			accumulator.attributes[attribute_index++] += attribute;
+		++bin_sizes[bin];
+		feature_bins.push_back(bin);
+	}
+
+	for(size_t bin = 0; bin < bins.size(); ++bin) {
+		bins[bin].x /= bin_sizes[bin];
+		bins[bin].y /= bin_sizes[bin];
+		for(double &attribute : bins[bin].attributes)
+			attribute /= bin_sizes[bin];
+	}
+	std::vector<std::pair<double, size_t>> closest_features(bins.size(), std::make_pair(std::numeric_limits<double>::infinity(), size_t(0)));
+	size_t feature_index = 0;
+	for(const feature_type &feature : features) {
+		size_t bin = feature_bins[feature_index];
+		double dx = CGAL::to_double(feature.get_geometry().x()) - bins[bin].x;
+		double dy = CGAL::to_double(feature.get_geometry().y()) - bins[bin].y;
+		double squared_distance = dx * dx + dy * dy;
+		if(squared_distance < closest_features[bin].first)
+			closest_features[bin] = std::make_pair(squared_distance, feature_index);
+		++feature_index;
+	}
+
+	site_features.clear();
+	site_features.reserve(bins.size());
+	for(size_t bin = 0; bin < bins.size(); ++bin) {
+		const feature_type &closest_feature = boost::begin(features)[closest_features[bin].second];
+		site_features.push_back(feature_type(closest_feature.get_id(), closest_feature.get_geometry(), bins[bin].attributes));
+	}
+}
+
+} // namespace geofis
+
+#endif /* FEATURE_BINNING_HPP_ */
@@ -0,0 +1,86 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef HEXAGONAL_FEATURE_BINNING_HPP_
+#define HEXAGONAL_FEATURE_BINNING_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace geofis {
+
+/**
+ * Bins the features into the pointy-top hexagonal cells whose centers are cell_size apart, a cell center being at
+ * the origin of the coordinates. The cell of a location is found by rounding its fractional cube coordinates, the
+ * cell is identified by its axial coordinates.
+ */
+struct hexagonal_feature_binning {
+
+	typedef std::pair<int64_t, int64_t> cell_type;
+
+	hexagonal_feature_binning(double cell_size = 1) : cell_size(cell_size) {}
+
+	cell_type get_cell(double x, double y) const {
+		double radius = cell_size / std::sqrt(3.0);
+		double q = (std::sqrt(3.0) / 3 * x - y / 3) / radius;
+		double r = (2.0 / 3 * y) / radius;
+		double s = -q - r;
+		double rounded_q = std::round(q);
+		double rounded_r = std::round(r);
+		double rounded_s = std::round(s);
+		double q_error = std::abs(rounded_q - q);
+		double r_error = std::abs(rounded_r - r);
+		double s_error = std::abs(rounded_s - s);
+		if(q_error > r_error && q_error > s_error)
+			rounded_q = -rounded_r - rounded_s;
+		else if(r_error > s_error)
+			rounded_r = -rounded_q - rounded_s;
+		return cell_type(int64_t(rounded_q), int64_t(rounded_r));
+	}
+
+	bool operator==(const hexagonal_feature_binning &other) const {
+		return cell_size == other.cell_size;
+	}
+
+	double cell_size;
+};
+
+} // namespace geofis
+
+#endif /* HEXAGONAL_FEATURE_BINNING_HPP_ */
@@ -36,20 +36,21 @@
  * The fact that you are presently reading this means that you have had
  * knowledge of the CeCILL license and that you accept its terms.
  */
-#ifndef H3AA76A54_494D_4D65_8865_86A868F26602
-#define H3AA76A54_494D_4D65_8865_86A868F26602
-
-#include <geofis/algorithm/zoning/pair/zone_pair_id_comparator.hpp>
+#ifndef NO_FEATURE_BINNING_HPP_
+#define NO_FEATURE_BINNING_HPP_
 
 namespace geofis {
 
-struct zone_pair_iterator_id_comparator {
+/**
+ * Without binning, each bounded feature is a site of the voronoi zones.
+ */
+struct no_feature_binning {
 
-	template <class ZonePairIterator> bool operator() (const ZonePairIterator &lhs, const ZonePairIterator &rhs) const {
-		return zone_pair_id_comparator()(*lhs, *rhs);
+	bool operator==(const no_feature_binning &) const {
+		return true;
 	}
 };
 
 } // namespace geofis
 
-#endif // H3AA76A54_494D_4D65_8865_86A868F26602 
+#endif /* NO_FEATURE_BINNING_HPP_ */
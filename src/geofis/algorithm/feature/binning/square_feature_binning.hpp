@@ -36,28 +36,35 @@
  * The fact that you are presently reading this means that you have had
  * knowledge of the CeCILL license and that you accept its terms.
  */
-#ifndef HA0EC2B67_7478_4580_9D06_C80729E8620F
-#define HA0EC2B67_7478_4580_9D06_C80729E8620F
+#ifndef SQUARE_FEATURE_BINNING_HPP_
+#define SQUARE_FEATURE_BINNING_HPP_
 
-#include <boost/tuple/tuple.hpp>
-#include <geofis/rcpp/feature/id_maker.hpp>
-#include <geofis/rcpp/geometry/geometry_maker.hpp>
+#include <cmath>
+#include <cstdint>
+#include <utility>
 
 namespace geofis {
 
-template <class Feature> struct rcpp_feature_maker {
+/**
+ * Bins the features into the square cells of side cell_size, the grid being aligned on the origin of the coordinates.
+ */
+struct square_feature_binning {
+
+	typedef std::pair<int64_t, int64_t> cell_type;
 
-	typedef typename Feature::id_type id_type;
-	typedef typename Feature::geometry_type geometry_type;
-	typedef Feature result_type;
+	square_feature_binning(double cell_size = 1) : cell_size(cell_size) {}
 
-	template <class Tuple> result_type operator()(const Tuple &tuple) const {
-		id_maker<id_type> id_maker;
-		geometry_maker<geometry_type> geometry_maker;
-		return result_type(id_maker(boost::get<0>(tuple)), geometry_maker(boost::get<1>(tuple)), boost::get<2>(tuple));
+	cell_type get_cell(double x, double y) const {
+		return cell_type(int64_t(std::floor(x / cell_size)), int64_t(std::floor(y / cell_size)));
 	}
+
+	bool operator==(const square_feature_binning &other) const {
+		return cell_size == other.cell_size;
+	}
+
+	double cell_size;
 };
 
 } // namespace geofis
 
-#endif // HA0EC2B67_7478_4580_9D06_C80729E8620F 
+#endif /* SQUARE_FEATURE_BINNING_HPP_ */
@@ -0,0 +1,94 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FEATURE_HILBERT_SORT_HPP_
+#define FEATURE_HILBERT_SORT_HPP_
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <boost/range.hpp>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Spatial_sort_traits_adapter_2.h>
+#include <CGAL/property_map.h>
+#include <CGAL/hilbert_sort.h>
+
+namespace geofis {
+
+struct feature_hilbert_sort_traits {
+
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel kernel_type;
+	typedef kernel_type::Point_2 point_type;
+	typedef std::pair<point_type, size_t> indexed_point_type;
+	typedef CGAL::First_of_pair_property_map<indexed_point_type> point_property_map_type;
+	typedef CGAL::Spatial_sort_traits_adapter_2<kernel_type, point_property_map_type> spatial_sort_traits_type;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reorders the features along a Hilbert curve of their locations.
+ *
+ * Neighbouring features are stored close to each other, so the voronoi zones, the zone infos and the zone neighbors
+ * built from them inherit this locality. The sort only uses the approximated locations and is deterministic for
+ * a given input order.
+ */
+template <class FeatureRange> void hilbert_sort_features(FeatureRange &features) {
+
+	typedef typename boost::range_value<FeatureRange>::type feature_type;
+	typedef feature_hilbert_sort_traits::point_type point_type;
+	typedef feature_hilbert_sort_traits::indexed_point_type indexed_point_type;
+	typedef feature_hilbert_sort_traits::spatial_sort_traits_type spatial_sort_traits_type;
+
+	std::vector<indexed_point_type> indexed_points;
+	indexed_points.reserve(boost::size(features));
+	size_t index = 0;
+	for(const feature_type &feature : features)
+		indexed_points.push_back(indexed_point_type(point_type(CGAL::to_double(feature.get_geometry().x()), CGAL::to_double(feature.get_geometry().y())), index++));
+	CGAL::hilbert_sort(indexed_points.begin(), indexed_points.end(), spatial_sort_traits_type());
+
+	std::vector<feature_type> sorted_features;
+	sorted_features.reserve(indexed_points.size());
+	for(const indexed_point_type &indexed_point : indexed_points)
+		sorted_features.push_back(std::move(boost::begin(features)[indexed_point.second]));
+	std::move(sorted_features.begin(), sorted_features.end(), boost::begin(features));
+}
+
+} // namespace geofis
+
+#endif /* FEATURE_HILBERT_SORT_HPP_ */
@@ -43,6 +43,7 @@
 #include <boost/range.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair_distance_less.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair_distance_equal.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_slab.hpp>
 
 namespace geofis {
 
@@ -56,6 +57,7 @@ start
 note right
 	std::list<>::sort is guaranteed to be stable.
 	see [[http://www.sgi.com/tech/stl/List.html]]
+	zone_pair_slab sorts its handles with std::stable_sort.
 end note
 
 :copy all **zone_pairs** iterators equals to minimum distance to the **output**;
@@ -78,6 +80,17 @@ struct minimum_aggregation {
 	    for ( ; (zone_pair_iterator != end_zone_pair_iterator) && (zone_pair_distance_equal()(*zone_pair_iterator, zone_pairs.front())) ; ++zone_pair_iterator)
 	    	*output = zone_pair_iterator;
 	}
+
+	template <class ZonePair, class OutputIterator> void operator()(zone_pair_slab<ZonePair> &zone_pairs, OutputIterator output) const {
+
+		typedef typename zone_pair_slab<ZonePair>::handle_container_type handle_container_type;
+
+		zone_pairs.stable_sort(zone_pair_distance_less());
+		const handle_container_type &handles = zone_pairs.get_handles();
+		const ZonePair &front_zone_pair = zone_pairs[handles.front()];
+		for(auto handle = boost::begin(handles); (handle != boost::end(handles)) && (zone_pair_distance_equal()(zone_pairs[*handle], front_zone_pair)); ++handle)
+			*output = *handle;
+	}
 };
 
 } // namespace geofis
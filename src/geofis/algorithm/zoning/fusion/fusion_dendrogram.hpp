@@ -0,0 +1,96 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FUSION_DENDROGRAM_HPP_
+#define FUSION_DENDROGRAM_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <boost/range.hpp>
+#include <util/assert.hpp>
+
+namespace geofis {
+
+/**
+ * Writes the fusion steps of leaf_size zones as the merge matrix, the heights and the leaf order of a hierarchical
+ * clustering, in the layout of the R hclust objects:
+ * - merges is the column major (leaf_size - 1) x 2 matrix of the fused zones of each step, a leaf being -(index + 1)
+ *   and the fusion zone of a previous step being (step + 1), the leaves first and by increasing values;
+ * - heights are the greatest fusion distances up to each step, so they are increasing;
+ * - order is the permutation of the leaves (index + 1) drawing the dendrogram without crossing.
+ *
+ * The zones of the steps are indexed as in zone_fusion_step, the leaves first then the fusion zone of each step. The
+ * fusion must be complete, with leaf_size - 1 steps.
+ */
+template <class ZoneFusionStepRange> void write_fusion_dendrogram(size_t leaf_size, const ZoneFusionStepRange &zone_fusion_steps, int *merges, double *heights, int *order) {
+	size_t step_size = boost::size(zone_fusion_steps);
+	UTIL_REQUIRE(leaf_size > 0 && step_size + 1 == leaf_size);
+	auto get_node = [leaf_size](size_t zone) { return zone < leaf_size ? -int(zone + 1) : int(zone - leaf_size + 1); };
+	auto precede = [](int node1, int node2) { return node1 < 0 ? node2 > 0 || node1 > node2 : node2 > 0 && node1 < node2; };
+	std::vector<std::pair<size_t, size_t>> children;
+	children.reserve(step_size);
+	size_t step = 0;
+	for(const auto &zone_fusion_step : zone_fusion_steps) {
+		int node1 = get_node(zone_fusion_step.zone1), node2 = get_node(zone_fusion_step.zone2);
+		if(precede(node2, node1))
+			std::swap(node1, node2);
+		merges[step] = node1;
+		merges[step + step_size] = node2;
+		heights[step] = step ? std::max(heights[step - 1], zone_fusion_step.distance) : zone_fusion_step.distance;
+		children.push_back(std::make_pair(zone_fusion_step.zone1, zone_fusion_step.zone2));
+		++step;
+	}
+	size_t order_size = 0;
+	std::vector<size_t> zones(1, leaf_size + step_size - 1);
+	while(!zones.empty()) {
+		size_t zone = zones.back();
+		zones.pop_back();
+		if(zone < leaf_size)
+			order[order_size++] = int(zone + 1);
+		else {
+			zones.push_back(children[zone - leaf_size].second);
+			zones.push_back(children[zone - leaf_size].first);
+		}
+	}
+}
+
+} // namespace geofis
+
+#endif /* FUSION_DENDROGRAM_HPP_ */
@@ -60,7 +60,8 @@ template <class FusionIterator> struct fusion_map_iterator_traits {
 	typedef std::list<zone_reference_type> zone_reference_container_type;
 	typedef fusion_map<zone_type> fusion_map_type;
 	typedef fusion_map_iterator<FusionIterator> fusion_map_iterator_type;
-	typedef boost::iterator_adaptor<fusion_map_iterator_type, FusionIterator, fusion_map_type, boost::use_default, fusion_map_type> base_type;
+	// the zones of a map are computed step by step from the previous map, so the traversal can't be random access
+	typedef boost::iterator_adaptor<fusion_map_iterator_type, FusionIterator, fusion_map_type, boost::bidirectional_traversal_tag, fusion_map_type> base_type;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
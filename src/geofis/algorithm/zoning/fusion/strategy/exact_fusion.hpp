@@ -36,28 +36,20 @@
  * The fact that you are presently reading this means that you have had
  * knowledge of the CeCILL license and that you accept its terms.
  */
-#ifndef HE54A6D03_5BEA_464A_8EF7_141058578F5B
-#define HE54A6D03_5BEA_464A_8EF7_141058578F5B
-
-#include <Rcpp.h>
-#include <geofis/rcpp/geometry/point_2_maker.hpp>
+#ifndef EXACT_FUSION_HPP_
+#define EXACT_FUSION_HPP_
 
 namespace geofis {
 
-template <class Geometry> struct geometry_maker;
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <class Kernel> struct geometry_maker<CGAL::Point_2<Kernel> > {
-
-	typedef typename point_2_maker<Kernel>::result_type result_type;
+/**
+ * The exact fusion merges the zone pairs one by one according to the aggregation, it selects no zone pair to merge
+ * before.
+ */
+struct exact_fusion {
 
-	template <int RTYPE> result_type operator()(const Rcpp::ConstMatrixRow<RTYPE> &row) const {
-		point_2_maker<Kernel> point_2_maker;
-		return point_2_maker(row);
-	}
+	template <class ZonePairRange, class OutputIterator> void operator()(ZonePairRange &, OutputIterator) const {}
 };
 
 } // namespace geofis
 
-#endif // HE54A6D03_5BEA_464A_8EF7_141058578F5B
+#endif /* EXACT_FUSION_HPP_ */
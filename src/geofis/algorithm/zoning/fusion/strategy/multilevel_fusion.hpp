@@ -0,0 +1,179 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef MULTILEVEL_FUSION_HPP_
+#define MULTILEVEL_FUSION_HPP_
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_distance_less.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_id_comparator.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_slab.hpp>
+
+namespace geofis {
+
+/*
+
+@startuml
+
+start
+
+if(zone count of **zone_pairs** <= **coarse_zone_size** ?) then (true)
+	end
+endif
+
+:find the nearest zone pair of each zone;
+
+while(zone with a nearest zone pair to check ?) is (true)
+	if(zone pair nearest to both of its zones ?) then (true)
+		:match both zones;
+		:find again the nearest zone pair of the unmatched zones
+		whose nearest zone pair has a matched zone;
+	endif
+endwhile (false)
+
+:sort the matched zone pairs by distance;
+
+:copy the first (zone count - **coarse_zone_size**) matched zone pairs to the **output**;
+
+end
+
+@enduml
+
+*/
+
+/**
+ * The multilevel fusion coarsens the zones before the exact fusion: each round selects a matching of the zone pairs,
+ * the closest pairs first, which are merged at once. The rounds go on until the zones are reduced to
+ * coarse_zone_size, the remaining zones being merged one by one by the exact fusion.
+ *
+ * The matching is the greedy matching of the zone pairs sorted by distance, then by id, built without sorting the zone
+ * pairs: a zone pair nearest to both of its zones among the unmatched zones is in the greedy matching, so the zone
+ * pairs are matched from the nearest zone pair of each zone, which is found again only when its other zone is
+ * matched. A round is linear in the number of zone pairs when the zones have a bounded number of neighbors.
+ *
+ * The zones of a matching are disjoint, so merging a matched pair does not update the other matched pairs. The
+ * fusions leading to the maps of more than coarse_zone_size zones are an approximation of the exact fusion, the
+ * fusions of the coarse zones are exact.
+ */
+struct multilevel_fusion {
+
+	static const size_t default_coarse_zone_size = 2000;
+
+	multilevel_fusion() : coarse_zone_size(default_coarse_zone_size) {}
+	multilevel_fusion(size_t coarse_zone_size) : coarse_zone_size(coarse_zone_size) {}
+
+	template <class ZonePair, class OutputIterator> void operator()(zone_pair_slab<ZonePair> &zone_pairs, OutputIterator output) const {
+
+		typedef typename zone_pair_slab<ZonePair>::zone_type zone_type;
+		typedef typename zone_pair_slab<ZonePair>::handle_type handle_type;
+		typedef typename zone_pair_slab<ZonePair>::handle_container_type handle_container_type;
+
+		if(zone_pairs.get_zone_size() <= coarse_zone_size)
+			return;
+		size_t fusion_size = zone_pairs.get_zone_size() - coarse_zone_size;
+		std::unordered_map<const zone_type *, size_t> zone_indices;
+		std::vector<const zone_type *> zones;
+		zone_indices.reserve(zone_pairs.get_zone_size());
+		zones.reserve(zone_pairs.get_zone_size());
+		for(handle_type handle : zone_pairs.get_handles())
+			for(const zone_type *zone : { &zone_pairs[handle].get_zone1(), &zone_pairs[handle].get_zone2() })
+				if(zone_indices.insert(std::make_pair(zone, zones.size())).second)
+					zones.push_back(zone);
+		auto get_other_zone = [&](handle_type handle, size_t zone) {
+			const ZonePair &zone_pair = zone_pairs[handle];
+			return zone_indices.find(&zone_pair.get_zone1() == zones[zone] ? &zone_pair.get_zone2() : &zone_pair.get_zone1())->second;
+		};
+		auto is_nearer = [&](handle_type lhs, handle_type rhs) {
+			if(zone_pair_distance_less()(zone_pairs[lhs], zone_pairs[rhs]))
+				return true;
+			return !zone_pair_distance_less()(zone_pairs[rhs], zone_pairs[lhs]) && zone_pair_id_comparator()(zone_pairs[lhs], zone_pairs[rhs]);
+		};
+		const handle_type no_handle = std::numeric_limits<handle_type>::max();
+		handle_container_type nearest_zone_pairs(zones.size(), no_handle);
+		std::vector<bool> matched_zones(zones.size(), false);
+		auto update_nearest_zone_pair = [&](size_t zone) {
+			handle_type &nearest_zone_pair = nearest_zone_pairs[zone];
+			nearest_zone_pair = no_handle;
+			for(handle_type handle : zone_pairs.get_zone_handles(*zones[zone]))
+				if(!matched_zones[get_other_zone(handle, zone)] && (nearest_zone_pair == no_handle || is_nearer(handle, nearest_zone_pair)))
+					nearest_zone_pair = handle;
+		};
+		std::vector<size_t> zones_to_check(zones.size());
+		for(size_t zone = 0; zone < zones.size(); ++zone) {
+			update_nearest_zone_pair(zone);
+			zones_to_check[zone] = zones.size() - 1 - zone;
+		}
+		handle_container_type matched_zone_pairs;
+		while(!zones_to_check.empty()) {
+			size_t zone = zones_to_check.back();
+			zones_to_check.pop_back();
+			handle_type nearest_zone_pair = nearest_zone_pairs[zone];
+			if(matched_zones[zone] || nearest_zone_pair == no_handle)
+				continue;
+			size_t other_zone = get_other_zone(nearest_zone_pair, zone);
+			if(nearest_zone_pairs[other_zone] != nearest_zone_pair)
+				continue;
+			matched_zones[zone] = matched_zones[other_zone] = true;
+			matched_zone_pairs.push_back(nearest_zone_pair);
+			for(size_t matched_zone : { zone, other_zone }) {
+				for(handle_type handle : zone_pairs.get_zone_handles(*zones[matched_zone])) {
+					size_t neighbor_zone = get_other_zone(handle, matched_zone);
+					if(!matched_zones[neighbor_zone] && nearest_zone_pairs[neighbor_zone] == handle) {
+						update_nearest_zone_pair(neighbor_zone);
+						zones_to_check.push_back(neighbor_zone);
+					}
+				}
+			}
+		}
+		std::stable_sort(matched_zone_pairs.begin(), matched_zone_pairs.end(), is_nearer);
+		matched_zone_pairs.resize(std::min(matched_zone_pairs.size(), fusion_size));
+		for(handle_type handle : matched_zone_pairs)
+			*output = handle;
+	}
+
+	size_t coarse_zone_size;
+};
+
+} // namespace geofis
+
+#endif /* MULTILEVEL_FUSION_HPP_ */
@@ -0,0 +1,164 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef RECIPROCAL_FUSION_HPP_
+#define RECIPROCAL_FUSION_HPP_
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <util/thread/thread_pool.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_distance_less.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_id_comparator.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_slab.hpp>
+#include <geofis/algorithm/zoning/fusion/aggregation/minimum_aggregation.hpp>
+
+namespace geofis {
+
+/*
+
+@startuml
+
+start
+
+:index the zones of **zone_pairs**\nwith their zone pairs indexed by **zone_pairs**;
+
+:find the nearest zone pair of each zone, concurrently;
+note right
+	the nearest zone pair is kept only if it is
+	strictly closer than the other zone pairs of the zone
+end note
+
+:copy the zone pairs nearest to both of their zones to the **output**, in id order;
+
+if(no zone pair copied ?) then (true)
+	:copy the first zone pair of the minimum aggregation to the **output**;
+endif
+
+end
+
+@enduml
+
+*/
+
+/**
+ * The reciprocal fusion merges at once the zone pairs whose zones are the nearest neighbors of each other. A zone
+ * pair strictly nearer than the other zone pairs of both of its zones is merged by the exact fusion too, whatever
+ * the fusions done before, as long as a fusion does not bring its zones nearer to the other zones: this is the case
+ * of the maximum zone distance, for which the fusion hierarchy is the one of the exact fusion. The fusions are then
+ * sorted by distance, which is the merging order of the exact fusion when the distances are distinct.
+ *
+ * With the minimum and mean zone distances, the zones of a fusion can be nearer to a zone than the zones were, as
+ * the neighborhood constrains the zone pairs, so the fusion process merges them with the exact fusion.
+ *
+ * The nearest zone pairs are searched on the threads of the fusion thread pool, created once per fusion by the fusion
+ * process, or else on thread_count threads, the default thread count when 0.
+ */
+struct reciprocal_fusion {
+
+	static const size_t zone_chunk_size = 1024;
+
+	reciprocal_fusion() : thread_count(0), fusion_thread_pool(nullptr) {}
+	reciprocal_fusion(size_t thread_count) : thread_count(thread_count), fusion_thread_pool(nullptr) {}
+
+	template <class ZonePair, class OutputIterator> void operator()(zone_pair_slab<ZonePair> &zone_pairs, OutputIterator output) const {
+
+		typedef typename ZonePair::zone_type zone_type;
+		typedef typename zone_pair_slab<ZonePair>::handle_type handle_type;
+		typedef typename zone_pair_slab<ZonePair>::handle_container_type handle_container_type;
+
+		if(zone_pairs.empty())
+			return;
+		const handle_container_type &handles = zone_pairs.get_handles();
+		std::unordered_map<const zone_type *, size_t> zone_indices;
+		std::vector<const handle_container_type *> zone_pair_handles;
+		for(handle_type handle : handles)
+			for(const zone_type *zone : { &zone_pairs[handle].get_zone1(), &zone_pairs[handle].get_zone2() })
+				if(zone_indices.insert(std::make_pair(zone, zone_indices.size())).second)
+					zone_pair_handles.push_back(&zone_pairs.get_zone_handles(*zone));
+		size_t zone_size = zone_indices.size();
+		const handle_type no_handle = std::numeric_limits<handle_type>::max();
+		handle_container_type nearest_zone_pairs(zone_size, no_handle);
+		const zone_pair_slab<ZonePair> &const_zone_pairs = zone_pairs;
+		auto find_nearest_zone_pairs = [&](size_t chunk) {
+			for(size_t zone = chunk * zone_chunk_size; zone < std::min(zone_size, (chunk + 1) * zone_chunk_size); ++zone)
+				nearest_zone_pairs[zone] = get_nearest_zone_pair(const_zone_pairs, zone_pair_handles[zone]->begin(), zone_pair_handles[zone]->end(), no_handle);
+		};
+		size_t chunk_size = (zone_size + zone_chunk_size - 1) / zone_chunk_size;
+		if(fusion_thread_pool)
+			fusion_thread_pool->run(chunk_size, find_nearest_zone_pairs);
+		else
+			util::thread_pool(thread_count ? thread_count : util::thread_pool::default_thread_count()).run(chunk_size, find_nearest_zone_pairs);
+		handle_container_type reciprocal_zone_pairs;
+		for(handle_type handle : handles) {
+			const ZonePair &zone_pair = zone_pairs[handle];
+			if(nearest_zone_pairs[zone_indices[&zone_pair.get_zone1()]] == handle && nearest_zone_pairs[zone_indices[&zone_pair.get_zone2()]] == handle)
+				reciprocal_zone_pairs.push_back(handle);
+		}
+		std::stable_sort(reciprocal_zone_pairs.begin(), reciprocal_zone_pairs.end(), [&](handle_type lhs, handle_type rhs) { return zone_pair_id_comparator()(zone_pairs[lhs], zone_pairs[rhs]); });
+		std::copy(reciprocal_zone_pairs.begin(), reciprocal_zone_pairs.end(), output);
+		if(reciprocal_zone_pairs.empty()) {
+			handle_container_type minimum_zone_pairs;
+			minimum_aggregation()(zone_pairs, std::back_inserter(minimum_zone_pairs));
+			*output = minimum_zone_pairs.front();
+		}
+	}
+
+	size_t thread_count;
+	util::thread_pool *fusion_thread_pool;
+
+private:
+	template <class ZonePair, class HandleIterator> static typename zone_pair_slab<ZonePair>::handle_type get_nearest_zone_pair(const zone_pair_slab<ZonePair> &zone_pairs, HandleIterator begin, HandleIterator end, typename zone_pair_slab<ZonePair>::handle_type no_handle) {
+		HandleIterator nearest = begin;
+		for(HandleIterator handle = std::next(begin); handle != end; ++handle)
+			if(zone_pairs[*handle].get_distance() < zone_pairs[*nearest].get_distance())
+				nearest = handle;
+		for(HandleIterator handle = begin; handle != end; ++handle)
+			if(handle != nearest && !zone_pair_distance_less()(zone_pairs[*nearest], zone_pairs[*handle]))
+				return no_handle;
+		return *nearest;
+	}
+};
+
+} // namespace geofis
+
+#endif /* RECIPROCAL_FUSION_HPP_ */
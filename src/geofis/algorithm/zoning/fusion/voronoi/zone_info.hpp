@@ -45,6 +45,8 @@
 #include <geofis/algorithm/zoning/fusion/zone/zone_range.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_info.hpp>
 #include <util/range/zipped_with_range.hpp>
+#include <util/range/permuted_range.hpp>
+#include <geofis/identifiable/identifiable_order.hpp>
 
 namespace geofis {
 
@@ -117,30 +119,36 @@ template <class ZoneRange, class VoronoiZoneRange> auto make_zone_info_range(Zon
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * The zones are stored in the order of the voronoi zones, they are iterated sorted by id.
+ */
 template <class Zone, class VoronoiZone> class zone_info_policy {
 
 	typedef std::vector<Zone> zone_container_type;
+	typedef std::vector<size_t> zone_order_type;
 
 public:
 	typedef zone_info<Zone, VoronoiZone> info_type;
-	typedef typename zone_container_type::iterator iterator;
-	typedef typename zone_container_type::const_iterator const_iterator;
+	typedef typename util::permuted_range_traits<zone_container_type, zone_order_type>::permuted_iterator_type iterator;
+	typedef typename util::permuted_range_traits<const zone_container_type, zone_order_type>::permuted_iterator_type const_iterator;
 
 	template <class VoronoiZoneRange> auto make_info_range(VoronoiZoneRange &voronoi_zones) {
 		util::assign(zones, make_zone_range<Zone>(voronoi_zones));
+		zone_order = make_identifiable_order(zones);
 		return make_zone_info_range(zones, voronoi_zones);
 	}
 
-	iterator begin() { return boost::begin(zones); }
-	iterator end() { return boost::end(zones); }
+	iterator begin() { return boost::make_permutation_iterator(boost::begin(zones), boost::begin(zone_order)); }
+	iterator end() { return boost::make_permutation_iterator(boost::begin(zones), boost::end(zone_order)); }
 
-	const_iterator begin() const { return boost::begin(zones); }
-	const_iterator end() const { return boost::end(zones); }
+	const_iterator begin() const { return boost::make_permutation_iterator(boost::begin(zones), boost::begin(zone_order)); }
+	const_iterator end() const { return boost::make_permutation_iterator(boost::begin(zones), boost::end(zone_order)); }
 
 	size_t size() const { return zones.size(); }
 
 private:
 	zone_container_type zones;
+	zone_order_type zone_order;
 };
 
 } // namespace geofis
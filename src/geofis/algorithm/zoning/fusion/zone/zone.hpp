@@ -57,7 +57,6 @@
 #include <util/iterator/output/back_insert_reference_iterator.hpp>
 #include <geofis/data/featurable.hpp>
 #include <geofis/geometry/geometrical.hpp>
-#include <geofis/geometry/area/geometry_area.hpp>
 #include <geofis/identifiable/identifiable_comparator.hpp>
 
 namespace geofis {
@@ -112,6 +111,7 @@ skinparam linetype ortho
 interface VoronoiZone {
 	+ get_attribute_range() : const_attribute_range_type
 	+ get_geometry() : geometry_type
+	+ get_area() : double
 }
 
 package "boost::accumulators" {
@@ -147,7 +147,8 @@ class zone<Geometry, VoronoiZone> {
 
 note right
   **area optimisation**
-  area is optional, determined from geometry if absent
+  area is optional, summed from the voronoi zone areas if absent,
+  so it never requires the geometry
   set_area() is private, called by friend class zone_area_computer
 end note
 
@@ -242,10 +243,8 @@ public:
 	}
 
 	double get_area() const {
-		if(!area) {
-			const_cast<zone *>(this)->compute_geometry();
-			const_cast<zone *>(this)->area = get_double_geometry_area(geometry.get());
-		}
+		if(!area)
+			const_cast<zone *>(this)->area = get_voronoi_zones_area();
 		return area.get();
 	}
 
@@ -280,10 +279,9 @@ public:
 	}
 
 	void merge(const zone &merged_zone) {
+		area = get_area() + merged_zone.get_area();
 		boost::copy(merged_zone.get_voronoi_zones(), util::back_inserter_reference(voronoi_zones));
 		id = boost::min_element(get_voronoi_zones(), identifiable_comparator())->get_id();
-		if(area)
-			area = area.get() + merged_zone.get_area();
 		geometry = boost::none;
 		attribute_accumulators.clear();
 	}
@@ -299,6 +297,13 @@ private:
 		this->area = area;
 	}
 
+	double get_voronoi_zones_area() const {
+		double area = 0;
+		for(const voronoi_zone_type &voronoi_zone : get_voronoi_zones())
+			area += voronoi_zone.get_area();
+		return area;
+	}
+
 	bool has_attributes() const {
 		return !attribute_accumulators.empty();
 	}
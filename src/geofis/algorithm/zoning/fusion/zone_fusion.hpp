@@ -62,12 +62,20 @@ show Zone methods
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 class zone_fusion<Zone> {
 	- fusion : Zone
+	- distance : double
 	+ <<constructor>> zone_fusion(zone_pair: ZonePair)
+	+ <<constructor>> zone_fusion(zone1: Zone, zone2: Zone, distance: double)
 	+ <<getter>> get_zone1(): Zone
 	+ <<getter>> get_zone2(): Zone
 	+ <<getter>> get_fusion(): Zone
+	+ <<getter>> get_distance(): double
 }
 
+note right of zone_fusion
+	**distance** is the zone_pair distance at the fusion step,
+	the height of the fusion in the fusion hierarchy
+end note
+
 zone_fusion o-- "zone1\nzone2" Zone
 
 @enduml
@@ -80,10 +88,14 @@ template <class Zone> class zone_fusion {
 public:
 	typedef Zone zone_type;
 
-	template <class ZonePair> zone_fusion(ZonePair &zone_pair) : zone1(zone_pair.get_zone1()), zone2(zone_pair.get_zone2()), fusion(boost::range::join(zone_pair.get_zone1().get_voronoi_zones(), zone_pair.get_zone2().get_voronoi_zones())) {
+	template <class ZonePair> zone_fusion(ZonePair &zone_pair) : zone1(zone_pair.get_zone1()), zone2(zone_pair.get_zone2()), fusion(boost::range::join(zone_pair.get_zone1().get_voronoi_zones(), zone_pair.get_zone2().get_voronoi_zones())), distance(zone_pair.get_distance()) {
 		compute_zone_area(fusion, zone1.get(), zone2.get());
 	}
 
+	zone_fusion(Zone &zone1, Zone &zone2, double distance) : zone1(zone1), zone2(zone2), fusion(boost::range::join(zone1.get_voronoi_zones(), zone2.get_voronoi_zones())), distance(distance) {
+		compute_zone_area(fusion, zone1, zone2);
+	}
+
 	Zone &get_zone1() { return zone1; }
 	Zone &get_zone2() { return zone2; }
 
@@ -93,6 +105,8 @@ public:
 	Zone &get_fusion() { return fusion; }
 	const Zone &get_fusion() const { return fusion; }
 
+	double get_distance() const { return distance; }
+
 	bool contain_zone(const Zone &zone) const {
 		return util::address_equal(zone, boost::unwrap_ref(zone1)) || util::address_equal(zone, boost::unwrap_ref(zone2));
 	}
@@ -101,6 +115,7 @@ private:
 	zone_reference_type zone1;
 	zone_reference_type zone2;
 	Zone fusion;
+	double distance;
 };
 
 } // namespace geofis
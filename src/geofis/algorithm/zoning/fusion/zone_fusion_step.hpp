@@ -36,27 +36,29 @@
  * The fact that you are presently reading this means that you have had
  * knowledge of the CeCILL license and that you accept its terms.
  */
-#ifndef HC577A271_39A4_4589_8FE4_A622F474C8FE
-#define HC577A271_39A4_4589_8FE4_A622F474C8FE
+#ifndef ZONE_FUSION_STEP_HPP_
+#define ZONE_FUSION_STEP_HPP_
 
-#include <Rcpp.h>
-#include <string>
+#include <cstddef>
 
 namespace geofis {
 
-template <class Id> struct id_maker;
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-template <> struct id_maker<std::string> {
+/**
+ * A fusion step without references to the zones, used to save and restore a fusion.
+ *
+ * The zones are indexed in creation order: the voronoi zones sorted by id first, then the fusion zone of each previous
+ * step.
+ */
+struct zone_fusion_step {
 
-	typedef std::string result_type;
+	zone_fusion_step() : zone1(0), zone2(0), distance(0) {}
+	zone_fusion_step(size_t zone1, size_t zone2, double distance) : zone1(zone1), zone2(zone2), distance(distance) {}
 
-	template<int RTYPE, template <class> class StoragePolicy> result_type operator()(const Rcpp::internal::const_string_proxy<RTYPE, StoragePolicy> &string_proxy) const {
-		return result_type(string_proxy);
-	}
+	size_t zone1;
+	size_t zone2;
+	double distance;
 };
 
 } // namespace geofis
 
-#endif // HC577A271_39A4_4589_8FE4_A622F474C8FE 
+#endif /* ZONE_FUSION_STEP_HPP_ */
@@ -0,0 +1,215 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ZONING_QUALITY_HPP_
+#define ZONING_QUALITY_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <boost/range.hpp>
+
+namespace geofis {
+
+/*
+@startuml
+
+title zoning_quality class diagram\n
+
+class zone_moments {
+	- size : size_t
+	- means : double [0..*]
+	- sums_of_squares : double [0..*]
+	+ <<constructor>> zone_moments(attributes: AttributeRange)
+	+ <<constructor>> zone_moments(moments1: zone_moments, moments2: zone_moments)
+	+ get_sum_of_squares(pos: size_t): double
+	+ get_variance(pos: size_t): double
+}
+
+class zoning_quality {
+	+ zone_size : size_t
+	+ variance_reductions : double [0..*]
+	+ relative_variances : double [0..*]
+	+ get_variance_reduction(): double
+	+ get_relative_variance(): double
+}
+
+class zoning_quality_accumulator {
+	- total_moments : zone_moments
+	- within_sums_of_squares : double [0..*]
+	- within_variance_sums : double [0..*]
+	- zone_size : size_t
+	+ add_zone(moments: zone_moments)
+	+ remove_zone(moments: zone_moments)
+	+ get_quality(): zoning_quality
+}
+
+zoning_quality_accumulator ..> zoning_quality : <<create>>
+zoning_quality_accumulator ..> zone_moments
+
+note bottom of zoning_quality
+	**variance reduction** of an attribute is 1 - W / T,
+	W being the within zone sum of squares and T the total sum
+	of squares of the attribute
+
+	**relative variance** of an attribute is the mean of the
+	variances of the zones divided by the total variance
+
+	the combined indices are the means of the attribute indices,
+	which are without unit, the constant attributes being ignored
+end note
+
+@enduml
+*/
+
+/**
+ * The size, means and sums of squared deviations of the attributes of a zone, the moments of two zones being merged in
+ * O(d) without reading their features.
+ */
+class zone_moments {
+
+public:
+	template <class AttributeRange> zone_moments(const AttributeRange &attributes) : size(1), means(boost::begin(attributes), boost::end(attributes)), sums_of_squares(means.size(), 0) {}
+
+	zone_moments(const zone_moments &moments1, const zone_moments &moments2) : size(moments1.size + moments2.size), means(moments1.means.size()), sums_of_squares(moments1.means.size()) {
+		double weight = double(moments1.size) * double(moments2.size) / double(size);
+		for(size_t pos = 0; pos < means.size(); ++pos) {
+			double delta = moments2.means[pos] - moments1.means[pos];
+			means[pos] = moments1.means[pos] + delta * double(moments2.size) / double(size);
+			sums_of_squares[pos] = moments1.sums_of_squares[pos] + moments2.sums_of_squares[pos] + delta * delta * weight;
+		}
+	}
+
+	size_t get_size() const { return size; }
+	size_t get_attribute_size() const { return means.size(); }
+	double get_mean(size_t pos) const { return means[pos]; }
+	double get_sum_of_squares(size_t pos) const { return sums_of_squares[pos]; }
+	double get_variance(size_t pos) const { return sums_of_squares[pos] / double(size); }
+
+private:
+	size_t size;
+	std::vector<double> means;
+	std::vector<double> sums_of_squares;
+};
+
+/**
+ * The quality indices of a zoning, per attribute and combined.
+ */
+struct zoning_quality {
+
+	size_t zone_size;
+	std::vector<double> variance_reductions;
+	std::vector<double> relative_variances;
+
+	double get_variance_reduction() const {
+		return get_mean(variance_reductions);
+	}
+
+	double get_relative_variance() const {
+		return get_mean(relative_variances);
+	}
+
+private:
+	// the NaN indices of the constant attributes are ignored
+	static double get_mean(const std::vector<double> &indices) {
+		double sum = 0;
+		size_t size = 0;
+		for(double index : indices) {
+			if(!std::isnan(index)) {
+				sum += index;
+				++size;
+			}
+		}
+		return size ? sum / double(size) : std::numeric_limits<double>::quiet_NaN();
+	}
+};
+
+/**
+ * Maintains the within zone sums of squares and the sums of the zone variances while the zones are added and removed,
+ * so that the quality of each zoning of a fusion is computed in O(d) per fusion step. The indices of an attribute with
+ * a null total variance are NaN.
+ */
+class zoning_quality_accumulator {
+
+public:
+	zoning_quality_accumulator(const zone_moments &total_moments) : total_moments(total_moments), within_sums_of_squares(total_moments.get_attribute_size(), 0), within_variance_sums(total_moments.get_attribute_size(), 0), zone_size(0) {}
+
+	void add_zone(const zone_moments &moments) {
+		for(size_t pos = 0; pos < within_sums_of_squares.size(); ++pos) {
+			within_sums_of_squares[pos] += moments.get_sum_of_squares(pos);
+			within_variance_sums[pos] += moments.get_variance(pos);
+		}
+		++zone_size;
+	}
+
+	void remove_zone(const zone_moments &moments) {
+		for(size_t pos = 0; pos < within_sums_of_squares.size(); ++pos) {
+			within_sums_of_squares[pos] -= moments.get_sum_of_squares(pos);
+			within_variance_sums[pos] -= moments.get_variance(pos);
+		}
+		--zone_size;
+	}
+
+	zoning_quality get_quality() const {
+		zoning_quality quality;
+		quality.zone_size = zone_size;
+		for(size_t pos = 0; pos < within_sums_of_squares.size(); ++pos) {
+			double total_sum_of_squares = total_moments.get_sum_of_squares(pos);
+			if(total_sum_of_squares > 0) {
+				quality.variance_reductions.push_back(1 - std::max(0.0, within_sums_of_squares[pos]) / total_sum_of_squares);
+				quality.relative_variances.push_back(std::max(0.0, within_variance_sums[pos]) / double(zone_size) / total_moments.get_variance(pos));
+			} else {
+				quality.variance_reductions.push_back(std::numeric_limits<double>::quiet_NaN());
+				quality.relative_variances.push_back(std::numeric_limits<double>::quiet_NaN());
+			}
+		}
+		return quality;
+	}
+
+private:
+	zone_moments total_moments;
+	std::vector<double> within_sums_of_squares;
+	std::vector<double> within_variance_sums;
+	size_t zone_size;
+};
+
+} // namespace geofis
+
+#endif /* ZONING_QUALITY_HPP_ */
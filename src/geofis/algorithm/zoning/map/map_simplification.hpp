@@ -0,0 +1,467 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef MAP_SIMPLIFICATION_HPP_
+#define MAP_SIMPLIFICATION_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <boost/functional/hash.hpp>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Polygon_2_algorithms.h>
+#include <geofis/algorithm/zoning/map/map.hpp>
+
+namespace geofis {
+
+/*
+
+@startuml
+
+class boundary_simplification<PolygonWithHoles> {
++ boundary_simplification(polygons : const PolygonWithHolesRange &)
++ simplify(tolerance : double) : std::vector<polygon_with_holes_type>
+}
+
+boundary_simplification *-- "*" arc : arcs
+boundary_simplification *-- "*" ring : rings
+
+note right of boundary_simplification
+  **topology**
+  the rings are split into arcs at the nodes, the vertices
+  with a number of neighbor vertices other than 2, a shared
+  arc being stored once and referenced by the rings of the
+  polygons on both sides
+
+  **simplification**
+  each arc is simplified once with the Douglas-Peucker
+  algorithm, keeping its end nodes, so the shared boundaries
+  stay gap free and overlap free; the arcs whose simplified
+  segments cross other segments, whose rings collapse, or
+  whose holes get out of their outer boundary, are simplified
+  again with a smaller tolerance until the boundaries are valid
+end note
+
+@enduml
+
+*/
+
+/**
+ * Topology preserving simplification of the boundaries of a partition of polygons with holes.
+ */
+template <class PolygonWithHoles> class boundary_simplification {
+
+	typedef PolygonWithHoles polygon_with_holes_type;
+	typedef typename polygon_with_holes_type::Polygon_2 polygon_type;
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel check_kernel_type;
+	typedef check_kernel_type::Point_2 check_point_type;
+	typedef check_kernel_type::Segment_2 check_segment_type;
+	typedef std::pair<double, double> coordinate_type;
+	typedef std::pair<size_t, size_t> vertex_pair_type;
+	typedef std::vector<size_t> vertex_index_container_type;
+
+	struct arc {
+		vertex_index_container_type vertices;
+		vertex_index_container_type simplified_vertices;
+		double tolerance;
+	};
+
+	struct arc_use {
+		size_t arc_index;
+		bool reversed;
+	};
+
+	typedef std::vector<arc_use> ring;
+
+	std::vector<coordinate_type> coordinates;
+	std::vector<arc> arcs;
+	std::vector<ring> rings;
+	std::vector<size_t> polygon_ring_offsets;
+	double minimum_tolerance;
+
+public:
+	template <class PolygonWithHolesRange> boundary_simplification(const PolygonWithHolesRange &polygons) {
+		std::vector<vertex_index_container_type> vertex_rings;
+		std::unordered_map<coordinate_type, size_t, boost::hash<coordinate_type>> vertex_indices;
+		polygon_ring_offsets.push_back(0);
+		for(const polygon_with_holes_type &polygon : polygons) {
+			vertex_rings.push_back(make_vertex_ring(polygon.outer_boundary(), vertex_indices));
+			for(auto hole = polygon.holes_begin(); hole != polygon.holes_end(); ++hole)
+				vertex_rings.push_back(make_vertex_ring(*hole, vertex_indices));
+			polygon_ring_offsets.push_back(vertex_rings.size());
+		}
+		initialize_arcs(vertex_rings);
+	}
+
+	/**
+	 * Returns the simplified polygons in the order of the input polygons, the simplified segments being at most at
+	 * the tolerance distance of the removed vertices.
+	 */
+	std::vector<polygon_with_holes_type> simplify(double tolerance) {
+		minimum_tolerance = tolerance / 64;
+		for(arc &boundary_arc : arcs) {
+			boundary_arc.tolerance = tolerance;
+			boundary_arc.simplified_vertices = simplify_arc(boundary_arc.vertices, tolerance);
+		}
+		while(refine_invalid_arcs())
+			;
+		std::vector<polygon_with_holes_type> polygons;
+		polygons.reserve(polygon_ring_offsets.size() - 1);
+		for(size_t polygon = 0; polygon + 1 < polygon_ring_offsets.size(); ++polygon) {
+			polygon_type outer_boundary = make_polygon(get_ring_vertices(rings[polygon_ring_offsets[polygon]]));
+			std::vector<polygon_type> holes;
+			for(size_t ring_index = polygon_ring_offsets[polygon] + 1; ring_index < polygon_ring_offsets[polygon + 1]; ++ring_index)
+				holes.push_back(make_polygon(get_ring_vertices(rings[ring_index])));
+			polygons.push_back(polygon_with_holes_type(outer_boundary, holes.begin(), holes.end()));
+		}
+		return polygons;
+	}
+
+private:
+	vertex_index_container_type make_vertex_ring(const polygon_type &polygon, std::unordered_map<coordinate_type, size_t, boost::hash<coordinate_type>> &vertex_indices) {
+		vertex_index_container_type vertex_ring;
+		for(auto vertex = polygon.vertices_begin(); vertex != polygon.vertices_end(); ++vertex) {
+			coordinate_type coordinate(CGAL::to_double(vertex->x()), CGAL::to_double(vertex->y()));
+			auto vertex_index = vertex_indices.emplace(coordinate, coordinates.size());
+			if(vertex_index.second)
+				coordinates.push_back(coordinate);
+			if(vertex_ring.empty() || vertex_ring.back() != vertex_index.first->second)
+				vertex_ring.push_back(vertex_index.first->second);
+		}
+		while(vertex_ring.size() > 1 && vertex_ring.back() == vertex_ring.front())
+			vertex_ring.pop_back();
+		return vertex_ring;
+	}
+
+	/**
+	 * A ring without node starts at its smallest vertex index, so the rings on both sides of a closed boundary start
+	 * at the same vertex. An arc is found again by its first edge, or by its last edge reversed.
+	 */
+	void initialize_arcs(const std::vector<vertex_index_container_type> &vertex_rings) {
+		std::vector<vertex_index_container_type> neighbors(coordinates.size());
+		for(const vertex_index_container_type &vertex_ring : vertex_rings) {
+			for(size_t index = 0; index < vertex_ring.size(); ++index) {
+				size_t vertex1 = vertex_ring[index], vertex2 = vertex_ring[(index + 1) % vertex_ring.size()];
+				neighbors[vertex1].push_back(vertex2);
+				neighbors[vertex2].push_back(vertex1);
+			}
+		}
+		std::vector<bool> nodes(coordinates.size());
+		for(size_t vertex = 0; vertex < coordinates.size(); ++vertex) {
+			std::sort(neighbors[vertex].begin(), neighbors[vertex].end());
+			nodes[vertex] = std::unique(neighbors[vertex].begin(), neighbors[vertex].end()) - neighbors[vertex].begin() != 2;
+		}
+		std::unordered_map<vertex_pair_type, size_t, boost::hash<vertex_pair_type>> arc_indices;
+		for(const vertex_index_container_type &vertex_ring : vertex_rings) {
+			size_t size = vertex_ring.size();
+			size_t start = std::find_if(vertex_ring.begin(), vertex_ring.end(), [&nodes](size_t vertex) { return nodes[vertex]; }) - vertex_ring.begin();
+			if(start == size)
+				start = std::min_element(vertex_ring.begin(), vertex_ring.end()) - vertex_ring.begin();
+			ring vertex_ring_arcs;
+			vertex_index_container_type arc_vertices(1, vertex_ring[start]);
+			for(size_t step = 1; step <= size; ++step) {
+				size_t vertex = vertex_ring[(start + step) % size];
+				arc_vertices.push_back(vertex);
+				if(nodes[vertex] || step == size) {
+					vertex_ring_arcs.push_back(get_arc_use(arc_vertices, arc_indices));
+					arc_vertices.assign(1, vertex);
+				}
+			}
+			rings.push_back(vertex_ring_arcs);
+		}
+	}
+
+	arc_use get_arc_use(const vertex_index_container_type &arc_vertices, std::unordered_map<vertex_pair_type, size_t, boost::hash<vertex_pair_type>> &arc_indices) {
+		size_t size = arc_vertices.size();
+		auto forward = arc_indices.find(vertex_pair_type(arc_vertices[0], arc_vertices[1]));
+		if(forward != arc_indices.end())
+			return arc_use{ forward->second, false };
+		auto backward = arc_indices.find(vertex_pair_type(arc_vertices[size - 1], arc_vertices[size - 2]));
+		if(backward != arc_indices.end())
+			return arc_use{ backward->second, true };
+		arc_indices.emplace(vertex_pair_type(arc_vertices[0], arc_vertices[1]), arcs.size());
+		arcs.push_back(arc{ arc_vertices, arc_vertices, 0 });
+		return arc_use{ arcs.size() - 1, false };
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	double get_segment_distance(size_t vertex, size_t source, size_t target) const {
+		double x = coordinates[vertex].first, y = coordinates[vertex].second;
+		double x1 = coordinates[source].first, y1 = coordinates[source].second;
+		double dx = coordinates[target].first - x1, dy = coordinates[target].second - y1;
+		double length = dx * dx + dy * dy;
+		double t = length > 0 ? std::max(0.0, std::min(1.0, ((x - x1) * dx + (y - y1) * dy) / length)) : 0;
+		return std::hypot(x - x1 - t * dx, y - y1 - t * dy);
+	}
+
+	// Douglas-Peucker simplification keeping the first and the last vertices
+	void simplify_section(const vertex_index_container_type &vertices, size_t first, size_t last, double tolerance, std::vector<bool> &kept) const {
+		std::vector<std::pair<size_t, size_t>> sections(1, std::make_pair(first, last));
+		while(!sections.empty()) {
+			std::pair<size_t, size_t> section = sections.back();
+			sections.pop_back();
+			double farthest_distance = 0;
+			size_t farthest = section.first;
+			for(size_t index = section.first + 1; index < section.second; ++index) {
+				double distance = get_segment_distance(vertices[index], vertices[section.first], vertices[section.second]);
+				if(distance > farthest_distance) {
+					farthest_distance = distance;
+					farthest = index;
+				}
+			}
+			if(farthest_distance > tolerance) {
+				kept[farthest] = true;
+				sections.push_back(std::make_pair(section.first, farthest));
+				sections.push_back(std::make_pair(farthest, section.second));
+			}
+		}
+	}
+
+	// a closed arc is split at its vertex farthest from its node, so it keeps at least three vertices
+	vertex_index_container_type simplify_arc(const vertex_index_container_type &vertices, double tolerance) const {
+		size_t last = vertices.size() - 1;
+		std::vector<bool> kept(vertices.size(), false);
+		kept[0] = kept[last] = true;
+		if(vertices.front() == vertices.back()) {
+			size_t farthest = 1;
+			for(size_t index = 2; index < last; ++index)
+				if(get_segment_distance(vertices[index], vertices[0], vertices[0]) > get_segment_distance(vertices[farthest], vertices[0], vertices[0]))
+					farthest = index;
+			kept[farthest] = true;
+			simplify_section(vertices, 0, farthest, tolerance, kept);
+			simplify_section(vertices, farthest, last, tolerance, kept);
+		} else
+			simplify_section(vertices, 0, last, tolerance, kept);
+		vertex_index_container_type simplified_vertices;
+		for(size_t index = 0; index < vertices.size(); ++index)
+			if(kept[index])
+				simplified_vertices.push_back(vertices[index]);
+		return simplified_vertices;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	vertex_index_container_type get_ring_vertices(const ring &boundary_ring, bool simplified = true) const {
+		vertex_index_container_type ring_vertices;
+		for(const arc_use &use : boundary_ring) {
+			const vertex_index_container_type &arc_vertices = simplified ? arcs[use.arc_index].simplified_vertices : arcs[use.arc_index].vertices;
+			if(use.reversed)
+				ring_vertices.insert(ring_vertices.end(), arc_vertices.rbegin(), arc_vertices.rend() - 1);
+			else
+				ring_vertices.insert(ring_vertices.end(), arc_vertices.begin(), arc_vertices.end() - 1);
+		}
+		return ring_vertices;
+	}
+
+	polygon_type make_polygon(const vertex_index_container_type &ring_vertices) const {
+		polygon_type polygon;
+		for(size_t vertex : ring_vertices)
+			polygon.push_back(typename polygon_type::Point_2(coordinates[vertex].first, coordinates[vertex].second));
+		return polygon;
+	}
+
+	check_point_type get_check_point(size_t vertex) const {
+		return check_point_type(coordinates[vertex].first, coordinates[vertex].second);
+	}
+
+	double get_ring_area(const vertex_index_container_type &ring_vertices) const {
+		double area = 0;
+		for(size_t index = 0; index < ring_vertices.size(); ++index) {
+			const coordinate_type &point1 = coordinates[ring_vertices[index]];
+			const coordinate_type &point2 = coordinates[ring_vertices[(index + 1) % ring_vertices.size()]];
+			area += point1.first * point2.second - point2.first * point1.second;
+		}
+		return area / 2;
+	}
+
+	/**
+	 * Simplifies again the arc with a smaller tolerance, the arc being restored when its tolerance falls below the
+	 * minimum tolerance, returns false when the arc is already restored.
+	 */
+	bool refine_arc(size_t arc_index) {
+		arc &boundary_arc = arcs[arc_index];
+		if(boundary_arc.simplified_vertices.size() == boundary_arc.vertices.size())
+			return false;
+		boundary_arc.tolerance /= 4;
+		if(boundary_arc.tolerance < minimum_tolerance)
+			boundary_arc.simplified_vertices = boundary_arc.vertices;
+		else
+			boundary_arc.simplified_vertices = simplify_arc(boundary_arc.vertices, boundary_arc.tolerance);
+		return true;
+	}
+
+	bool refine_ring(const ring &boundary_ring) {
+		bool refined = false;
+		for(const arc_use &use : boundary_ring)
+			refined |= refine_arc(use.arc_index);
+		return refined;
+	}
+
+	// the first vertex of the hole not on the outer boundary tells if the hole is inside the outer boundary
+	bool is_hole_outside(const vertex_index_container_type &outer_vertices, const vertex_index_container_type &hole_vertices) const {
+		std::vector<check_point_type> outer_points;
+		outer_points.reserve(outer_vertices.size());
+		for(size_t vertex : outer_vertices)
+			outer_points.push_back(get_check_point(vertex));
+		for(size_t vertex : hole_vertices) {
+			CGAL::Bounded_side side = CGAL::bounded_side_2(outer_points.begin(), outer_points.end(), get_check_point(vertex), check_kernel_type());
+			if(side != CGAL::ON_BOUNDARY)
+				return side == CGAL::ON_UNBOUNDED_SIDE;
+		}
+		return false;
+	}
+
+	/**
+	 * Refines the arcs of the collapsed or reversed rings, of the holes outside their outer boundary, and the arcs
+	 * whose segments cross, returns false when the boundaries are valid.
+	 */
+	bool refine_invalid_arcs() {
+		bool refined = false;
+		for(const ring &boundary_ring : rings) {
+			vertex_index_container_type simplified_vertices = get_ring_vertices(boundary_ring);
+			double simplified_area = simplified_vertices.size() < 3 ? 0 : get_ring_area(simplified_vertices);
+			double area = get_ring_area(get_ring_vertices(boundary_ring, false));
+			if(simplified_area == 0 || (simplified_area > 0) != (area > 0))
+				refined |= refine_ring(boundary_ring);
+		}
+		for(size_t polygon = 0; polygon + 1 < polygon_ring_offsets.size(); ++polygon) {
+			const ring &outer_ring = rings[polygon_ring_offsets[polygon]];
+			for(size_t ring_index = polygon_ring_offsets[polygon] + 1; ring_index < polygon_ring_offsets[polygon + 1]; ++ring_index) {
+				if(is_hole_outside(get_ring_vertices(outer_ring), get_ring_vertices(rings[ring_index]))) {
+					refined |= refine_ring(outer_ring);
+					refined |= refine_ring(rings[ring_index]);
+				}
+			}
+		}
+		if(refined)
+			return true;
+		return refine_crossing_arcs();
+	}
+
+	struct arc_segment {
+		size_t arc_index;
+		size_t source;
+		size_t target;
+	};
+
+	// the crossings are searched in a grid of the segments
+	bool refine_crossing_arcs() {
+		std::vector<arc_segment> segments;
+		double min_x = HUGE_VAL, min_y = HUGE_VAL, max_x = -HUGE_VAL, max_y = -HUGE_VAL;
+		for(size_t arc_index = 0; arc_index < arcs.size(); ++arc_index) {
+			const vertex_index_container_type &arc_vertices = arcs[arc_index].simplified_vertices;
+			for(size_t index = 0; index + 1 < arc_vertices.size(); ++index)
+				segments.push_back(arc_segment{ arc_index, arc_vertices[index], arc_vertices[index + 1] });
+			for(size_t vertex : arc_vertices) {
+				min_x = std::min(min_x, coordinates[vertex].first);
+				min_y = std::min(min_y, coordinates[vertex].second);
+				max_x = std::max(max_x, coordinates[vertex].first);
+				max_y = std::max(max_y, coordinates[vertex].second);
+			}
+		}
+		if(segments.empty())
+			return false;
+		size_t grid_size = std::max<size_t>(1, size_t(std::sqrt(double(segments.size()))));
+		double cell_width = std::max((max_x - min_x) / grid_size, std::numeric_limits<double>::min());
+		double cell_height = std::max((max_y - min_y) / grid_size, std::numeric_limits<double>::min());
+		auto get_column = [&](double x) { return std::min(grid_size - 1, size_t((x - min_x) / cell_width)); };
+		auto get_row = [&](double y) { return std::min(grid_size - 1, size_t((y - min_y) / cell_height)); };
+		std::vector<std::vector<size_t>> cells(grid_size * grid_size);
+		for(size_t segment = 0; segment < segments.size(); ++segment) {
+			const coordinate_type &source = coordinates[segments[segment].source];
+			const coordinate_type &target = coordinates[segments[segment].target];
+			for(size_t column = get_column(std::min(source.first, target.first)); column <= get_column(std::max(source.first, target.first)); ++column)
+				for(size_t row = get_row(std::min(source.second, target.second)); row <= get_row(std::max(source.second, target.second)); ++row)
+					cells[row * grid_size + column].push_back(segment);
+		}
+		bool refined = false;
+		for(const std::vector<size_t> &cell : cells)
+			for(size_t index1 = 0; index1 < cell.size(); ++index1)
+				for(size_t index2 = index1 + 1; index2 < cell.size(); ++index2)
+					if(are_crossing(segments[cell[index1]], segments[cell[index2]])) {
+						refined |= refine_arc(segments[cell[index1]].arc_index);
+						refined |= refine_arc(segments[cell[index2]].arc_index);
+					}
+		return refined;
+	}
+
+	// segments sharing a vertex cross when they overlap, the other segments when they intersect
+	bool are_crossing(const arc_segment &segment1, const arc_segment &segment2) const {
+		check_segment_type check_segment1(get_check_point(segment1.source), get_check_point(segment1.target));
+		check_segment_type check_segment2(get_check_point(segment2.source), get_check_point(segment2.target));
+		size_t shared_vertex = segment1.source == segment2.source || segment1.source == segment2.target ? segment1.source : segment1.target == segment2.source || segment1.target == segment2.target ? segment1.target : coordinates.size();
+		if(shared_vertex == coordinates.size())
+			return CGAL::do_intersect(check_segment1, check_segment2);
+		size_t other_vertex1 = segment1.source == shared_vertex ? segment1.target : segment1.source;
+		size_t other_vertex2 = segment2.source == shared_vertex ? segment2.target : segment2.source;
+		if(other_vertex1 == other_vertex2)
+			return true;
+		return check_segment1.has_on(get_check_point(other_vertex2)) || check_segment2.has_on(get_check_point(other_vertex1));
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the map with the boundaries of its zones simplified at the tolerance distance, the zone areas being kept.
+ */
+template <class Zone> map<Zone> simplify_map(const map<Zone> &zone_map, double tolerance) {
+
+	typedef typename Zone::geometry_type geometry_type;
+
+	std::vector<Zone> zones(boost::begin(zone_map.get_zones()), boost::end(zone_map.get_zones()));
+	std::vector<geometry_type> geometries;
+	geometries.reserve(zones.size());
+	for(const Zone &zone : zones) {
+		zone.get_area();
+		geometries.push_back(zone.get_geometry());
+	}
+	geometries = boundary_simplification<geometry_type>(geometries).simplify(tolerance);
+	for(size_t index = 0; index < zones.size(); ++index)
+		zones[index].set_geometry(geometries[index]);
+	return map<Zone>(zones);
+}
+
+} // namespace geofis
+
+#endif /* MAP_SIMPLIFICATION_HPP_ */
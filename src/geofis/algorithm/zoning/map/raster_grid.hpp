@@ -0,0 +1,116 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef RASTER_GRID_HPP_
+#define RASTER_GRID_HPP_
+
+#include <cmath>
+#include <algorithm>
+#include <CGAL/Bbox_2.h>
+#include <CGAL/enum.h>
+#include <util/assert.hpp>
+
+namespace geofis {
+
+/**
+ * Grid of square cells, the origin being the upper left corner of the grid and the rows going down from it.
+ */
+struct raster_grid {
+
+	raster_grid() : x_origin(0), y_origin(0), cell_size(1), column_size(0), row_size(0) {}
+	raster_grid(double x_origin, double y_origin, double cell_size, size_t column_size, size_t row_size) : x_origin(x_origin), y_origin(y_origin), cell_size(cell_size), column_size(column_size), row_size(row_size) {}
+
+	size_t size() const {
+		return column_size * row_size;
+	}
+
+	double get_x(size_t column) const {
+		return x_origin + (column + 0.5) * cell_size;
+	}
+
+	double get_y(size_t row) const {
+		return y_origin - (row + 0.5) * cell_size;
+	}
+
+	double x_origin;
+	double y_origin;
+	double cell_size;
+	size_t column_size;
+	size_t row_size;
+};
+
+/**
+ * Makes the grid covering an extent, the grid being extended to the right and to the bottom up to whole cells.
+ */
+inline raster_grid make_raster_grid(const CGAL::Bbox_2 &extent, double cell_size) {
+	UTIL_REQUIRE(cell_size > 0);
+	size_t column_size = std::max<size_t>(1, size_t(std::ceil((extent.xmax() - extent.xmin()) / cell_size)));
+	size_t row_size = std::max<size_t>(1, size_t(std::ceil((extent.ymax() - extent.ymin()) / cell_size)));
+	return raster_grid(extent.xmin(), extent.ymax(), cell_size, column_size, row_size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Scans the cells of the grid column by column, calling the visitor with the index of each cell whose center is
+ * inside the border and with the voronoi zone containing this center. The cells are indexed in the column-major
+ * order of the scan.
+ *
+ * The voronoi zone of a center is the zone of its nearest site, located by a walk in the delaunay triangulation
+ * starting from the site of the previous center, so the scan does not depend on the zone geometries.
+ */
+template <class VoronoiMap, class BorderIndex, class Visitor> void scan_raster_zones(const raster_grid &grid, const VoronoiMap &voronoi_map, const BorderIndex &border_index, Visitor visitor) {
+
+	typedef typename VoronoiMap::vertex_handle_type vertex_handle_type;
+	typedef typename BorderIndex::point_type point_type;
+
+	vertex_handle_type hint;
+	size_t cell = 0;
+	for(size_t column = 0; column < grid.column_size; ++column) {
+		double x = grid.get_x(column);
+		for(size_t row = 0; row < grid.row_size; ++row, ++cell) {
+			double y = grid.get_y(row);
+			if(border_index.bounded_side(point_type(x, y)) != CGAL::ON_UNBOUNDED_SIDE)
+				visitor(cell, voronoi_map.locate_zone(x, y, hint));
+		}
+	}
+}
+
+} // namespace geofis
+
+#endif /* RASTER_GRID_HPP_ */
@@ -0,0 +1,146 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ZONE_GEOMETRY_CACHE_HPP_
+#define ZONE_GEOMETRY_CACHE_HPP_
+
+#include <vector>
+#include <cstddef>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <util/cache/lru_cache.hpp>
+#include <geofis/algorithm/zoning/map/map.hpp>
+
+namespace geofis {
+
+/**
+ * Weighs a polygon with holes by the estimated memory of its vertices, an exact vertex holding its point handle, its
+ * interval approximation and its exact representation.
+ */
+struct zone_geometry_weigher {
+
+	static const size_t vertex_bytes = 64;
+
+	template <class PolygonWithHoles> size_t operator()(const PolygonWithHoles &geometry) const {
+		size_t vertex_size = geometry.outer_boundary().size();
+		for(auto hole = geometry.holes_begin(); hole != geometry.holes_end(); ++hole)
+			vertex_size += hole->size();
+		return sizeof(PolygonWithHoles) + vertex_size * vertex_bytes;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Caches the geometries of the zones of the fusion dendrogram, up to a budget of bytes, the least recently used
+ * geometries being evicted first.
+ *
+ * A zone of a map is a dendrogram zone when it has the voronoi zones of the fusion map zone beginning with its first
+ * voronoi zone, the zones enlarged by the merge are not cached. The dendrogram zones are identified by their address,
+ * so the cache must be cleared when the fusion is released.
+ */
+template <class Zone> class zone_geometry_cache {
+
+	typedef typename Zone::geometry_type geometry_type;
+	typedef typename Zone::voronoi_zone_type voronoi_zone_type;
+	typedef util::lru_cache<const Zone *, geometry_type, std::hash<const Zone *>, zone_geometry_weigher> geometry_cache_type;
+
+public:
+	zone_geometry_cache(size_t budget) : geometries(budget), hit_size(0), miss_size(0) {}
+
+	size_t get_budget() const {
+		return geometries.get_capacity();
+	}
+
+	void set_budget(size_t budget) {
+		geometries.set_capacity(budget);
+	}
+
+	size_t get_hit_size() const {
+		return hit_size;
+	}
+
+	size_t get_miss_size() const {
+		return miss_size;
+	}
+
+	size_t get_resident_bytes() const {
+		return geometries.get_weight();
+	}
+
+	void clear() {
+		geometries.clear();
+	}
+
+	/**
+	 * Returns the map with the geometries of its dendrogram zones, read from the cache or computed and cached. The
+	 * cached geometries are read first, so the zones shared with the previous maps are kept when the new zones evict
+	 * the least recently used geometries.
+	 */
+	template <class FusionZoneRange> map<Zone> load_geometries(const map<Zone> &zone_map, const FusionZoneRange &fusion_zones) {
+		std::unordered_map<const voronoi_zone_type *, const Zone *> first_voronoi_zone_fusion_zones;
+		for(const Zone &fusion_zone : fusion_zones)
+			first_voronoi_zone_fusion_zones.emplace(&fusion_zone.get_voronoi_zone(0), &fusion_zone);
+		std::vector<Zone> zones(boost::begin(zone_map.get_zones()), boost::end(zone_map.get_zones()));
+		std::vector<std::pair<Zone *, const Zone *>> missed_zones;
+		for(Zone &zone : zones) {
+			auto fusion_zone = first_voronoi_zone_fusion_zones.find(&zone.get_voronoi_zone(0));
+			if(fusion_zone == first_voronoi_zone_fusion_zones.end() || fusion_zone->second->size() != zone.size())
+				continue;
+			if(const geometry_type *geometry = geometries.find(fusion_zone->second)) {
+				zone.set_geometry(*geometry);
+				++hit_size;
+			} else
+				missed_zones.push_back(std::make_pair(&zone, fusion_zone->second));
+		}
+		for(const auto &missed_zone : missed_zones) {
+			geometries.insert(missed_zone.second, missed_zone.first->get_geometry());
+			++miss_size;
+		}
+		return map<Zone>(zones);
+	}
+
+private:
+	geometry_cache_type geometries;
+	size_t hit_size;
+	size_t miss_size;
+};
+
+} // namespace geofis
+
+#endif /* ZONE_GEOMETRY_CACHE_HPP_ */
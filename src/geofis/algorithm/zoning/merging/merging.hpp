@@ -47,6 +47,7 @@
 #include <util/iterator/output/back_insert_reference_iterator.hpp>
 #include <util/range/algorithm/copy_if.hpp>
 #include <util/assert.hpp>
+#include <util/progress/progress_monitor.hpp>
 #include <list>
 
 namespace geofis {
@@ -223,11 +224,19 @@ public:
 	}
 
 	template <class ZoneNeighborPredicate, class ZoneDistance, class ZonePairMerger> void compute_merge_zones(const ZoneNeighborPredicate &zone_neighbor_predicate, const ZoneDistance &zone_distance, const ZonePairMerger &zone_pair_merger) {
+		util::null_progress progress;
+		compute_merge_zones(zone_neighbor_predicate, zone_distance, zone_pair_merger, progress);
+	}
+
+	/**
+	 * Steps the progress for each merged zone.
+	 */
+	template <class ZoneNeighborPredicate, class ZoneDistance, class ZonePairMerger, class Progress> void compute_merge_zones(const ZoneNeighborPredicate &zone_neighbor_predicate, const ZoneDistance &zone_distance, const ZonePairMerger &zone_pair_merger, Progress &progress) {
 		while(!merged_zones.empty()) {
 #ifndef R_PACKAGE
 			size_t merged_zones_size = merged_zones.size();
 #endif
-			compute_merged_zones(boost::begin(merged_zones), boost::end(merged_zones), zone_neighbor_predicate, zone_distance, zone_pair_merger);
+			compute_merged_zones(boost::begin(merged_zones), boost::end(merged_zones), zone_neighbor_predicate, zone_distance, zone_pair_merger, progress);
 #ifndef R_PACKAGE
 			UTIL_ENSURE( merged_zones_size != merged_zones.size() );
 #endif
@@ -239,13 +248,14 @@ private:
 		boost::algorithm::partition_copy(zones, std::back_inserter(mergeable_zones), std::back_inserter(merged_zones), mergeable_predicate);
 	}
 
-	template <class ZoneNeighborPredicate, class ZoneDistance, class ZonePairMerger> void compute_merged_zones(zone_iterator_type iterator, zone_iterator_type last_iterator, const ZoneNeighborPredicate &zone_neighbor_predicate, const ZoneDistance &zone_distance, const ZonePairMerger &zone_pair_merger) {
+	template <class ZoneNeighborPredicate, class ZoneDistance, class ZonePairMerger, class Progress> void compute_merged_zones(zone_iterator_type iterator, zone_iterator_type last_iterator, const ZoneNeighborPredicate &zone_neighbor_predicate, const ZoneDistance &zone_distance, const ZonePairMerger &zone_pair_merger, Progress &progress) {
 		while(iterator != last_iterator) {
 			if(compute_merged_zone(*iterator, zone_neighbor_predicate, zone_distance, zone_pair_merger)) {
 				zone_iterator_type erase_iterator = iterator;
 				zone_iterator_type next_iterator = ++iterator;
 				merged_zones.erase(erase_iterator);
 				iterator = next_iterator;
+				progress.step();
 			} else
 				++iterator;
 		}
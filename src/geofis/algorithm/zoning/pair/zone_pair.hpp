@@ -101,7 +101,7 @@ template <class Zone, class ZonePairDistance> class zone_pair {
 	typedef boost::optional<zone_reference_type> updated_zone_type;
 
 	template <class FeatureDistance> friend class zone_pair_distance_updater;
-	template <class ZonePairDistanceUpdater> friend class zone_pair_updater;
+	template <class ZonePairDistanceUpdater, class ZonePair> friend class zone_pair_updater;
 
 public:
 	typedef Zone zone_type;
@@ -60,7 +60,7 @@ hide FeatureDistance members
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 
 class zone_pair_distance_updater<FeatureDistance> {
-	+ operator()(value: std::pair<ZonePairIterator, VariantValue>) : void
+	+ operator()(zone_pair: ZonePair, value: VariantValue) : void
 }
 
 hide zone_pair_distance_updater members
@@ -69,7 +69,7 @@ show zone_pair_distance_updater methods
 zone_pair_distance_updater o-- "feature_distance" FeatureDistance
 
 note right of zone_pair_distance_updater::operator()
-  std::pair<ZonePairIterator, VariantValue> is std::map value_type
+  VariantValue is the updated zone_pair value
   see update_zone_pairs documentation
 end note
 
@@ -81,8 +81,8 @@ template <class FeatureDistance> class zone_pair_distance_updater {
 public:
 	zone_pair_distance_updater(const FeatureDistance &feature_distance) : feature_distance(feature_distance) {}
 
-	template <class ZonePairIterator, class VariantValue> void operator()(const std::pair<ZonePairIterator, VariantValue> &value) const {
-		update_zone_pair_distance(*value.first, value.second);
+	template <class ZonePair, class VariantValue> void operator()(ZonePair &zone_pair, const VariantValue &value) const {
+		update_zone_pair_distance(zone_pair, value);
 	}
 
 private:
@@ -0,0 +1,251 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ZONE_PAIR_SLAB_HPP_
+#define ZONE_PAIR_SLAB_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <boost/optional.hpp>
+#include <util/assert.hpp>
+
+namespace geofis {
+
+/*
+@startuml
+
+title zone_pair_slab class diagram
+
+class zone_pair_slab<ZonePair> {
+	- slots : std::vector<boost::optional<ZonePair> >
+	- handles : std::vector<handle_type>
+	- free_handles : std::vector<handle_type>
+	- released_handles : std::vector<handle_type>
+	- orders : std::vector<size_t>
+	- zone_handles : std::unordered_map<const Zone *, std::vector<handle_type> >
+	+ insert(ZonePair) : handle_type
+	+ erase(handle_type) : void
+	+ get_handles() : std::vector<handle_type>
+	+ get_order(handle_type) : size_t
+	+ get_zone_handles(Zone) : std::vector<handle_type>
+	+ merge_zones(Zone, Zone, Zone) : std::vector<handle_type>
+	+ stable_sort(Compare) : void
+}
+
+note right of zone_pair_slab
+	**slots** are recycled from **free_handles**
+	a handle stays valid until its zone_pair is erased
+
+	**handles** is the zone_pairs order
+	an erased handle is released, then freed on the next
+	compaction of **handles**, so it can't be reused while
+	it is still referenced by **handles**
+
+	**orders** increase with the position of the handles
+	in **handles**, so the zone_pairs of a zone are ordered
+	without scanning **handles**
+
+	**zone_handles** indexes the zone_pairs of each zone
+	so that a fusion updates the zone_pairs of its zones only
+end note
+
+@enduml
+*/
+
+template <class ZonePair> class zone_pair_slab {
+
+	typedef boost::optional<ZonePair> slot_type;
+	typedef std::vector<slot_type> slot_container_type;
+
+public:
+	typedef ZonePair value_type;
+	typedef typename ZonePair::zone_type zone_type;
+	typedef size_t handle_type;
+	typedef std::vector<handle_type> handle_container_type;
+
+	zone_pair_slab() : zone_pair_size(0), next_order(0) {}
+
+	handle_type insert(const ZonePair &zone_pair) {
+		handle_type handle = allocate_slot();
+		slots[handle] = zone_pair;
+		orders[handle] = next_order++;
+		handles.push_back(handle);
+		zone_handles[&zone_pair.get_zone1()].push_back(handle);
+		zone_handles[&zone_pair.get_zone2()].push_back(handle);
+		++zone_pair_size;
+		return handle;
+	}
+
+	template <class ZonePairRange> void insert(const ZonePairRange &zone_pairs) {
+		handles.reserve(handles.size() + boost::size(zone_pairs));
+		for(const ZonePair &zone_pair : zone_pairs)
+			insert(zone_pair);
+	}
+
+	void erase(handle_type handle) {
+		UTIL_REQUIRE(slots[handle]);
+		erase_zone_handle(slots[handle]->get_zone1(), handle);
+		erase_zone_handle(slots[handle]->get_zone2(), handle);
+		slots[handle] = boost::none;
+		released_handles.push_back(handle);
+		--zone_pair_size;
+	}
+
+	ZonePair &operator[](handle_type handle) { return *slots[handle]; }
+	const ZonePair &operator[](handle_type handle) const { return *slots[handle]; }
+
+	size_t size() const { return zone_pair_size; }
+	bool empty() const { return zone_pair_size == 0; }
+
+	/**
+	 * Returns the number of zones of the zone_pairs.
+	 */
+	size_t get_zone_size() const { return zone_handles.size(); }
+
+	/**
+	 * Returns the order of a zone_pair: the zone_pairs are in increasing order in the handles.
+	 */
+	size_t get_order(handle_type handle) const { return orders[handle]; }
+
+	/**
+	 * Returns the handles of the zone_pairs of a zone, in no particular order.
+	 */
+	const handle_container_type &get_zone_handles(const zone_type &zone) const {
+		static const handle_container_type no_handles;
+		auto zone_handle = zone_handles.find(&zone);
+		return zone_handle == zone_handles.end() ? no_handles : zone_handle->second;
+	}
+
+	/**
+	 * Moves the zone_pairs of zone1 and zone2 to their fusion and returns them, the zones of the zone_pairs being
+	 * then updated to the fusion by the caller.
+	 */
+	const handle_container_type &merge_zones(const zone_type &zone1, const zone_type &zone2, const zone_type &fusion) {
+		handle_container_type fusion_handles;
+		for(const zone_type *zone : { &zone1, &zone2 }) {
+			auto zone_handle = zone_handles.find(zone);
+			if(zone_handle != zone_handles.end()) {
+				fusion_handles.insert(fusion_handles.end(), zone_handle->second.begin(), zone_handle->second.end());
+				zone_handles.erase(zone_handle);
+			}
+		}
+		UTIL_REQUIRE(!zone_handles.count(&fusion));
+		if(fusion_handles.empty())
+			return get_zone_handles(fusion);
+		handle_container_type &merged_handles = zone_handles[&fusion];
+		merged_handles.swap(fusion_handles);
+		return merged_handles;
+	}
+
+	/**
+	 * Returns the handles of the zone_pairs in their current order.
+	 */
+	const handle_container_type &get_handles() {
+		compact();
+		return handles;
+	}
+
+	/**
+	 * Sorts the zone_pairs with a stable sort, as std::list<>::sort does.
+	 */
+	template <class Compare> void stable_sort(const Compare &compare) {
+		compact();
+		std::stable_sort(handles.begin(), handles.end(), handle_comparator<Compare>(*this, compare));
+		for(next_order = 0; next_order < handles.size(); ++next_order)
+			orders[handles[next_order]] = next_order;
+	}
+
+private:
+	slot_container_type slots;
+	handle_container_type handles;
+	handle_container_type free_handles;
+	handle_container_type released_handles;
+	std::vector<size_t> orders;
+	std::unordered_map<const zone_type *, handle_container_type> zone_handles;
+	size_t zone_pair_size;
+	size_t next_order;
+
+	template <class Compare> struct handle_comparator {
+
+		handle_comparator(const zone_pair_slab &zone_pairs, const Compare &compare) : zone_pairs(zone_pairs), compare(compare) {}
+
+		bool operator()(handle_type lhs, handle_type rhs) const {
+			return compare(zone_pairs[lhs], zone_pairs[rhs]);
+		}
+
+		const zone_pair_slab &zone_pairs;
+		const Compare &compare;
+	};
+
+	handle_type allocate_slot() {
+		if(free_handles.empty()) {
+			slots.push_back(slot_type());
+			orders.push_back(0);
+			return slots.size() - 1;
+		}
+		handle_type handle = free_handles.back();
+		free_handles.pop_back();
+		return handle;
+	}
+
+	void erase_zone_handle(const zone_type &zone, handle_type handle) {
+		auto zone_handle = zone_handles.find(&zone);
+		UTIL_REQUIRE(zone_handle != zone_handles.end());
+		handle_container_type &zone_pair_handles = zone_handle->second;
+		auto position = std::find(zone_pair_handles.begin(), zone_pair_handles.end(), handle);
+		UTIL_REQUIRE(position != zone_pair_handles.end());
+		*position = zone_pair_handles.back();
+		zone_pair_handles.pop_back();
+		if(zone_pair_handles.empty())
+			zone_handles.erase(zone_handle);
+	}
+
+	void compact() {
+		if(released_handles.empty())
+			return;
+		handles.erase(std::remove_if(handles.begin(), handles.end(), [this](handle_type handle) { return !slots[handle]; }), handles.end());
+		free_handles.insert(free_handles.end(), released_handles.begin(), released_handles.end());
+		released_handles.clear();
+	}
+};
+
+} // namespace geofis
+
+#endif /* ZONE_PAIR_SLAB_HPP_ */
@@ -39,19 +39,19 @@
 #ifndef UPDATE_ZONE_PAIR_HPP_
 #define UPDATE_ZONE_PAIR_HPP_
 
-#include <map>
-#include <list>
 #include <vector>
+#include <utility>
+#include <algorithm>
 #include <util/address_equal.hpp>
 #include <util/functional/binary_reference_adaptor.hpp>
 #include <boost/ref.hpp>
 #include <boost/variant.hpp>
 #include <boost/optional.hpp>
-#include <boost/range/algorithm/for_each.hpp>
 //#include <geofis/algorithm/zoning/zone_pair_equal.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_slab.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair_distance_updater.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair_feature_distance.hpp>
-#include <geofis/algorithm/zoning/pair/zone_pair_iterator_id_comparator.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_id_comparator.hpp>
 
 namespace geofis {
 
@@ -70,11 +70,11 @@ note left: optional reference to updated zone
 
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 
-interface updated_zone_pair_iterator_type <<(T,#FF7700)typedef>>
+interface value_type <<(T,#FF7700)typedef>>
 
-hide updated_zone_pair_iterator_type members
+hide value_type members
 
-note right: iterator to std::map\nsee update_zone_pairs documentation
+note right: variant value to update a zone_pair distance\nsee update_zone_pairs documentation
 
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 
@@ -90,28 +90,47 @@ ZonePair ..> updated_zone_type : <<use>>
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 
 interface ZonePairDistanceUpdater {
-	+ operator()(updated_zone_pair_iterator_type): void
+	+ operator()(ZonePair, value_type): void
 }
 
 hide ZonePairDistanceUpdater members
 show ZonePairDistanceUpdater methods
 
-ZonePairDistanceUpdater ..> updated_zone_pair_iterator_type : <<use>>
+ZonePairDistanceUpdater ..> value_type : <<use>>
 
 '''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''
 
-class zone_pair_updater<ZonePairDistanceUpdater> {
+class zone_pair_updater<ZonePairDistanceUpdater, ZonePair> {
 	- zone_pair_distance_updater : ZonePairDistanceUpdater
-	+ update_zone_pairs(std::list<ZonePair>, ZoneFusion, std::list<ZonePairIterator>) : void
+	- fusion_zone_pairs : std::vector<handle_type>
+	- updated_zone_pairs : std::vector<std::pair<handle_type, value_type> >
+	- duplicate_zone_pairs : std::vector<handle_type>
+	+ update_zone_pairs(zone_pair_slab<ZonePair>, ZoneFusion, std::vector<handle_type>) : void
 }
 
+note bottom of zone_pair_updater
+	**fusion_zone_pairs**, **updated_zone_pairs** and **duplicate_zone_pairs**
+	are scratch buffers reused from one update to the next
+end note
+
 zone_pair_updater ..> ZonePair : <<call>>
 zone_pair_updater ..> ZonePairDistanceUpdater : <<call>>
 
 @enduml
 */
 
-template <class ZonePairDistanceUpdater> class zone_pair_updater {
+template <class ZonePairDistanceUpdater, class ZonePair> class zone_pair_updater {
+
+	typedef zone_pair_slab<ZonePair> zone_pair_container_type;
+	typedef typename zone_pair_container_type::handle_type handle_type;
+	typedef typename zone_pair_container_type::handle_container_type handle_container_type;
+	typedef typename ZonePair::zone_type zone_type;
+	typedef boost::reference_wrapper<zone_type> zone_reference_type;
+	typedef std::pair<zone_reference_type, zone_reference_type> zone_pair_reference_type;
+	typedef boost::variant<const ZonePair *, zone_pair_reference_type> value_type;
+	typedef std::pair<handle_type, value_type> updated_zone_pair_type;
+	typedef std::vector<updated_zone_pair_type> updated_zone_pair_container_type;
+	typedef boost::optional<zone_reference_type> updated_zone_type;
 
 public:
 	zone_pair_updater(const ZonePairDistanceUpdater &zone_pair_distance_updater) : zone_pair_distance_updater(zone_pair_distance_updater) {}
@@ -121,7 +140,7 @@ public:
 
 	start
 
-	:update all **zone_pairs** according to **zone_fusion**
+	:update the **zone_pairs** of the zones of **zone_fusion**
 	copy duplicate **zone_pairs** in **duplicate_zone_pairs**;
 	note left
 	 	 **zone_pairs** must be ordered in merging order
@@ -135,31 +154,42 @@ public:
 	@enduml
 	*/
 
-	template <class ZonePair, class ZoneFusion, class ZonePairIterator> void update_zone_pairs(std::list<ZonePair> &zone_pairs, ZoneFusion &zone_fusion, std::list<ZonePairIterator> &zone_pairs_to_merge) const {
-
-		typedef typename std::list<ZonePair>::iterator zone_pair_iterator_type;
-
-		std::vector<zone_pair_iterator_type> duplicate_zone_pairs;
-		update_zone_pairs(boost::begin(zone_pairs), boost::end(zone_pairs), zone_fusion, std::back_inserter(duplicate_zone_pairs));
-		remove_zone_pairs_to_merge(zone_pairs_to_merge, duplicate_zone_pairs);
-		remove_zone_pairs(zone_pairs, duplicate_zone_pairs);
+	template <class ZoneFusion> void update_zone_pairs(zone_pair_container_type &zone_pairs, ZoneFusion &zone_fusion, handle_container_type &zone_pairs_to_merge) {
+		duplicate_zone_pairs.clear();
+		update_zone_pairs(zone_pairs, zone_fusion);
+		remove_zone_pairs_to_merge(zone_pairs_to_merge);
+		remove_zone_pairs(zone_pairs);
 	}
 
 private:
 	ZonePairDistanceUpdater zone_pair_distance_updater;
+	handle_container_type fusion_zone_pairs;
+	updated_zone_pair_container_type updated_zone_pairs;
+	handle_container_type duplicate_zone_pairs;
 
-	template <class Zone, class ZonePair, class ZoneFusion> std::pair<boost::reference_wrapper<Zone>, boost::reference_wrapper<Zone> > make_zone_pair_to_compute_distance(boost::reference_wrapper<Zone> &updated_zone, ZonePair &zone_pair, ZoneFusion &zone_fusion) const {
+	template <class Zone, class ZoneFusion> std::pair<boost::reference_wrapper<Zone>, boost::reference_wrapper<Zone> > make_zone_pair_to_compute_distance(boost::reference_wrapper<Zone> &updated_zone, ZonePair &zone_pair, ZoneFusion &zone_fusion) const {
 		return make_zone_pair_to_compute_distance(boost::unwrap_ref(updated_zone), zone_pair, zone_fusion);
 	}
 
-	template <class Zone, class ZonePair> Zone &get_other_zone(Zone &zone, ZonePair &zone_pair) const {
+	template <class Zone, class OtherZonePair> Zone &get_other_zone(Zone &zone, OtherZonePair &zone_pair) const {
 		return util::address_equal(zone, zone_pair.get_zone1()) ? zone_pair.get_zone2() : zone_pair.get_zone1();
 	}
 
-	template <class Zone, class ZonePair, class ZoneFusion> std::pair<boost::reference_wrapper<Zone>, boost::reference_wrapper<Zone> > make_zone_pair_to_compute_distance(Zone &updated_zone, ZonePair &zone_pair, ZoneFusion &zone_fusion) const {
+	template <class Zone, class ZoneFusion> std::pair<boost::reference_wrapper<Zone>, boost::reference_wrapper<Zone> > make_zone_pair_to_compute_distance(Zone &updated_zone, ZonePair &zone_pair, ZoneFusion &zone_fusion) const {
 		return std::make_pair(boost::ref(get_other_zone(updated_zone, zone_fusion)), boost::ref(get_other_zone(zone_fusion.get_fusion(), zone_pair)));
 	}
 
+	struct updated_zone_pair_id_comparator {
+
+		updated_zone_pair_id_comparator(const zone_pair_container_type &zone_pairs) : zone_pairs(zone_pairs) {}
+
+		bool operator()(const updated_zone_pair_type &lhs, const updated_zone_pair_type &rhs) const {
+			return zone_pair_id_comparator()(zone_pairs[lhs.first], zone_pairs[rhs.first]);
+		}
+
+		const zone_pair_container_type &zone_pairs;
+	};
+
 	/**
 
 	@startuml
@@ -170,9 +200,17 @@ private:
 
 	start
 
-	floating note left: In this diagram **zone_pair** is an iterator type.
+	floating note left: In this diagram **zone_pair** is a handle type.
 
-	while (for each **zone_pair** in **zone_pairs**)
+	:move the **zone_pairs** of the zones of **zone_fusion** to the fusion zone
+	copy them in **fusion_zone_pairs**;
+	:sort **fusion_zone_pairs** by **zone_pairs** order;
+	note left
+		the other **zone_pairs** are not updated by **zone_fusion**
+		so they are not read
+	end note
+
+	while (for each **zone_pair** in **fusion_zone_pairs**)
 		:update zones of **zone_pair** according to **zone_fusion**;
 		note left
 			zone updating replace zone in **zone_pair** with **zone_fusion**
@@ -186,31 +224,36 @@ private:
 		if (**zone_pair** updated ?) then (yes)
 			:copy **zone_pair** in **updated_zone_pairs**;
 			note left
-				  **updated_zone_pairs** is a std::map<Key, Value, Compare>
+				  **updated_zone_pairs** is a std::vector<std::pair<Key, Value> >
 
 				  * **Key** is a **zone_pair**
 				  * **Value** is a variant value to update **zone_pair** distance
-				  * **Compare** is **zone_pair** id comparator
-
-				  this guarantees about **zone_pair** uniqueness
 			end note
-
-			if (**zone_pair** already present in **updated_zone_pairs** ?) then (yes)
-				:copy **zone_pair** in **duplicate_zone_pairs**;
-			else (no)
-			endif
 		else (no)
 		endif
 	end while
 
+	:stable sort **updated_zone_pairs** by **zone_pair** id comparator;
+
 	while (for each **zone_pair** in **updated_zone_pairs**)
+		if (**zone_pair** equal to a previous **zone_pair** ?) then (yes)
+			:copy **zone_pair** in **duplicate_zone_pairs**;
+			note left
+				this guarantees about **zone_pair** uniqueness
+				the first **zone_pair** in **zone_pairs** order is kept
+			end note
+		else (no)
+		endif
+	end while
+
+	while (for each kept **zone_pair** in **updated_zone_pairs**)
 		:update **zone_pair** distance;
 		note left
 			the CA **zone_pair** distance must be updated with CB distance
 			* need to compute the CB distance
 			* in case of duplicate the CB distance is already computed
 
-			so the the **Value** in std::map **updated_zone_pairs** is variant
+			so the **Value** in **updated_zone_pairs** is variant
 			* std::pair<C, B>
 			* **zone_pair** CB in case of duplicate
 		end note
@@ -221,58 +264,39 @@ private:
 	@enduml
 	*/
 
-	template <class ZonePairIterator, class ZoneFusion, class OutputDuplicateZonePair> void update_zone_pairs(ZonePairIterator zone_pair, ZonePairIterator end_zone_pair, ZoneFusion &zone_fusion, OutputDuplicateZonePair duplicate_zone_pairs) const {
-
-		typedef typename ZoneFusion::zone_type zone_type;
-		typedef boost::reference_wrapper<zone_type> zone_reference_type;
-		typedef std::pair<zone_reference_type, zone_reference_type> zone_pair_reference_type;
-		typedef boost::variant<ZonePairIterator, zone_pair_reference_type> value_type;
-		typedef std::map<ZonePairIterator, value_type, zone_pair_iterator_id_comparator> updated_zone_pairs_type;
-		typedef typename updated_zone_pairs_type::iterator updated_zone_pair_iterator_type;
-		typedef boost::optional<zone_reference_type> updated_zone_type;
-
-		updated_zone_pairs_type updated_zone_pairs;
-		for(; zone_pair != end_zone_pair; ++zone_pair) {
-			updated_zone_type updated_zone = zone_pair->update_zones(zone_fusion);
-			if(updated_zone) {
-				std::pair<updated_zone_pair_iterator_type, bool> insert_result = updated_zone_pairs.insert(std::make_pair(zone_pair, make_zone_pair_to_compute_distance(boost::get(updated_zone), *zone_pair, zone_fusion)));
-				if(!insert_result.second) {
-					*duplicate_zone_pairs = zone_pair;
-					insert_result.first->second = zone_pair;
-				}
+	template <class ZoneFusion> void update_zone_pairs(zone_pair_container_type &zone_pairs, ZoneFusion &zone_fusion) {
+		updated_zone_pairs.clear();
+		const handle_container_type &zone_pair_handles = zone_pairs.merge_zones(zone_fusion.get_zone1(), zone_fusion.get_zone2(), zone_fusion.get_fusion());
+		fusion_zone_pairs.assign(zone_pair_handles.begin(), zone_pair_handles.end());
+		std::sort(fusion_zone_pairs.begin(), fusion_zone_pairs.end(), [&zone_pairs](handle_type lhs, handle_type rhs) { return zone_pairs.get_order(lhs) < zone_pairs.get_order(rhs); });
+		for(handle_type handle : fusion_zone_pairs) {
+			ZonePair &zone_pair = zone_pairs[handle];
+			updated_zone_type updated_zone = zone_pair.update_zones(zone_fusion);
+			if(updated_zone)
+				updated_zone_pairs.push_back(updated_zone_pair_type(handle, make_zone_pair_to_compute_distance(boost::get(updated_zone), zone_pair, zone_fusion)));
+		}
+		updated_zone_pair_id_comparator comparator(zone_pairs);
+		std::stable_sort(updated_zone_pairs.begin(), updated_zone_pairs.end(), comparator);
+		typename updated_zone_pair_container_type::iterator updated_zone_pair = updated_zone_pairs.begin();
+		while(updated_zone_pair != updated_zone_pairs.end()) {
+			typename updated_zone_pair_container_type::iterator duplicate_zone_pair = updated_zone_pair + 1;
+			for(; (duplicate_zone_pair != updated_zone_pairs.end()) && !comparator(*updated_zone_pair, *duplicate_zone_pair); ++duplicate_zone_pair) {
+				duplicate_zone_pairs.push_back(duplicate_zone_pair->first);
+				updated_zone_pair->second = &zone_pairs[duplicate_zone_pair->first];
 			}
+			zone_pair_distance_updater(zone_pairs[updated_zone_pair->first], updated_zone_pair->second);
+			updated_zone_pair = duplicate_zone_pair;
 		}
-		boost::for_each(updated_zone_pairs, zone_pair_distance_updater);
 	}
 
-	template <class ZonePairIteratorContainer> struct remove_from_zone_pairs_to_merge {
-
-		remove_from_zone_pairs_to_merge(ZonePairIteratorContainer &zone_pairs_to_merge) : zone_pairs_to_merge(zone_pairs_to_merge) {}
-
-		template <class ZonePairIterator> void operator()(const ZonePairIterator &zone_pair_iterator) const {
-			zone_pairs_to_merge.remove(zone_pair_iterator);
-		}
-
-		ZonePairIteratorContainer &zone_pairs_to_merge;
-	};
-
-	template <class ZonePairIteratorContainer, class DuplicateZonePairRange> void remove_zone_pairs_to_merge(ZonePairIteratorContainer &zone_pairs_to_merge, const DuplicateZonePairRange &duplicate_zone_pairs) const {
-		boost::for_each(duplicate_zone_pairs, remove_from_zone_pairs_to_merge<ZonePairIteratorContainer>(zone_pairs_to_merge));
+	void remove_zone_pairs_to_merge(handle_container_type &zone_pairs_to_merge) const {
+		for(handle_type duplicate_zone_pair : duplicate_zone_pairs)
+			zone_pairs_to_merge.erase(std::remove(zone_pairs_to_merge.begin(), zone_pairs_to_merge.end(), duplicate_zone_pair), zone_pairs_to_merge.end());
 	}
 
-	template <class ZonePairContainer> struct remove_from_zone_pairs {
-
-		remove_from_zone_pairs(ZonePairContainer &zone_pairs) : zone_pairs(zone_pairs) {}
-
-		template <class ZonePairIterator> void operator()(const ZonePairIterator &zone_pair_iterator) const {
-			zone_pairs.erase(zone_pair_iterator);
-		}
-
-		ZonePairContainer &zone_pairs;
-	};
-
-	template <class ZonePairContainer, class DuplicateZonePairRange> void remove_zone_pairs(ZonePairContainer &zone_pairs, const DuplicateZonePairRange &duplicate_zone_pairs) const {
-		boost::for_each(duplicate_zone_pairs, remove_from_zone_pairs<ZonePairContainer>(zone_pairs));
+	void remove_zone_pairs(zone_pair_container_type &zone_pairs) const {
+		for(handle_type duplicate_zone_pair : duplicate_zone_pairs)
+			zone_pairs.erase(duplicate_zone_pair);
 	}
 };
 
@@ -0,0 +1,332 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef SPANNING_TREE_PARTITION_HPP_
+#define SPANNING_TREE_PARTITION_HPP_
+
+#include <queue>
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <geofis/algorithm/zoning/fusion/zone_fusion_step.hpp>
+
+namespace geofis {
+
+/**
+ * An edge of the neighbor graph between two vertices, weighted by the distance of their features.
+ */
+struct spanning_tree_edge {
+
+	spanning_tree_edge() : vertex1(0), vertex2(0), weight(0) {}
+	spanning_tree_edge(size_t vertex1, size_t vertex2, double weight) : vertex1(vertex1), vertex2(vertex2), weight(weight) {}
+
+	size_t vertex1;
+	size_t vertex2;
+	double weight;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+
+@startuml
+
+title spanning_tree_partition activity diagram\n
+
+start
+
+:compute the minimum spanning forest of the **edges** with Kruskal algorithm;
+note right
+	the **edges** are sorted by weight with a stable sort,
+	so the forest only depends on the **edges** order
+end note
+
+:push each tree of the forest with its best cut in the **trees** queue;
+
+while(**trees** empty ?) is (false)
+	:pop the tree of the best cut;
+	:remove the cut edge, the tree is split in the subtree of the cut and the rest;
+	:push each part with its best cut in the **trees** queue;
+endwhile (true)
+
+:replay the cuts in reverse order as fusion steps;
+
+end
+
+@enduml
+
+*/
+
+/**
+ * Partitions the minimum spanning forest of a weighted neighbor graph by removing its edges one by one, as the SKATER
+ * regionalization does. The removed edge is the one whose cut most reduces the heterogeneity of its tree, the sum of
+ * the squared deviations of the vertex attributes from the tree means, among the edges of all the trees. Reversed,
+ * the cuts are a hierarchy of fusions: the fusion steps index the vertices first, then the fusion of each previous
+ * step, and the distance of a step is the heterogeneity reduction of its cut.
+ *
+ * The best cut of a tree is found in linear time with the attribute sums of its subtrees, a subtree being contiguous
+ * in the preorder of the tree. Each cut computes again the best cuts of the two parts only, so the partition takes the
+ * sum of the sizes of the split trees, N log N for balanced cuts, against the N^2 of the agglomerative fusion.
+ *
+ * The attributes are given vertex by vertex, attribute_size values for each vertex.
+ */
+class spanning_tree_partition {
+
+	typedef std::vector<size_t> vertex_container_type;
+	typedef std::vector<spanning_tree_edge> edge_container_type;
+	typedef std::pair<size_t, size_t> adjacent_type;
+	typedef std::vector<zone_fusion_step> zone_fusion_step_container_type;
+
+	struct tree {
+
+		tree() : cut_vertex(0), cut_edge(0), cut_gain(0) {}
+
+		vertex_container_type vertices;
+		size_t cut_vertex;
+		size_t cut_edge;
+		double cut_gain;
+	};
+
+	/**
+	 * Orders the trees by cut gain, the first vertex of the trees breaking the ties.
+	 */
+	struct tree_cut_less {
+
+		bool operator()(const tree &lhs, const tree &rhs) const {
+			return lhs.cut_gain == rhs.cut_gain ? lhs.vertices.front() > rhs.vertices.front() : lhs.cut_gain < rhs.cut_gain;
+		}
+	};
+
+public:
+	spanning_tree_partition(size_t vertex_size, size_t attribute_size, const std::vector<double> &attributes) : vertex_size(vertex_size), attribute_size(attribute_size), attributes(attributes), adjacents(vertex_size), parents(vertex_size), sizes(vertex_size), sums(vertex_size * attribute_size), square_sums(vertex_size * attribute_size) {}
+
+	/**
+	 * Returns the fusion steps of the partition of the minimum spanning forest of the edges, the progress is stepped
+	 * for each cut.
+	 */
+	template <class Progress> zone_fusion_step_container_type operator()(const edge_container_type &edges, Progress &progress) {
+		compute_spanning_forest(edges);
+		std::priority_queue<tree, std::vector<tree>, tree_cut_less> trees;
+		for(vertex_container_type &vertices : get_forest_vertices())
+			push_tree(trees, vertices);
+		std::vector<size_t> cut_edges;
+		cut_edges.reserve(forest_edges.size());
+		while(!trees.empty()) {
+			tree cut_tree = trees.top();
+			trees.pop();
+			cut_edges.push_back(cut_tree.cut_edge);
+			cut_gains.push_back(cut_tree.cut_gain);
+			removed_edges[cut_tree.cut_edge] = true;
+			vertex_container_type subtree_vertices;
+			vertex_container_type other_vertices;
+			split_tree(cut_tree, subtree_vertices, other_vertices);
+			push_tree(trees, subtree_vertices);
+			push_tree(trees, other_vertices);
+			progress.step();
+		}
+		return get_fusion_steps(cut_edges);
+	}
+
+private:
+	size_t vertex_size;
+	size_t attribute_size;
+	const std::vector<double> &attributes;
+	edge_container_type forest_edges;
+	std::vector<bool> removed_edges;
+	std::vector<double> cut_gains;
+	std::vector<std::vector<adjacent_type> > adjacents;
+	vertex_container_type parents;
+	vertex_container_type sizes;
+	std::vector<double> sums;
+	std::vector<double> square_sums;
+
+	static size_t find_root(vertex_container_type &roots, size_t vertex) {
+		while(roots[vertex] != vertex)
+			vertex = roots[vertex] = roots[roots[vertex]];
+		return vertex;
+	}
+
+	void compute_spanning_forest(const edge_container_type &edges) {
+		edge_container_type sorted_edges(edges);
+		std::stable_sort(sorted_edges.begin(), sorted_edges.end(), [](const spanning_tree_edge &lhs, const spanning_tree_edge &rhs) { return lhs.weight < rhs.weight; });
+		vertex_container_type roots(vertex_size);
+		std::iota(roots.begin(), roots.end(), size_t(0));
+		for(const spanning_tree_edge &edge : sorted_edges) {
+			size_t root1 = find_root(roots, edge.vertex1);
+			size_t root2 = find_root(roots, edge.vertex2);
+			if(root1 == root2)
+				continue;
+			roots[std::max(root1, root2)] = std::min(root1, root2);
+			adjacents[edge.vertex1].push_back(adjacent_type(edge.vertex2, forest_edges.size()));
+			adjacents[edge.vertex2].push_back(adjacent_type(edge.vertex1, forest_edges.size()));
+			forest_edges.push_back(edge);
+		}
+		removed_edges.assign(forest_edges.size(), false);
+	}
+
+	std::vector<vertex_container_type> get_forest_vertices() const {
+		std::vector<vertex_container_type> forest_vertices;
+		std::vector<bool> visited(vertex_size, false);
+		for(size_t vertex = 0; vertex < vertex_size; ++vertex) {
+			if(visited[vertex])
+				continue;
+			vertex_container_type vertices(1, vertex);
+			visited[vertex] = true;
+			for(size_t index = 0; index < vertices.size(); ++index)
+				for(const adjacent_type &adjacent : adjacents[vertices[index]])
+					if(!visited[adjacent.first]) {
+						visited[adjacent.first] = true;
+						vertices.push_back(adjacent.first);
+					}
+			forest_vertices.push_back(vertices);
+		}
+		return forest_vertices;
+	}
+
+	/**
+	 * Sorts the vertices of the tree in preorder from its smallest vertex, computes the sizes and the attribute sums
+	 * of the subtrees and keeps the cut of maximum gain.
+	 */
+	template <class TreeQueue> void push_tree(TreeQueue &trees, vertex_container_type &vertices) {
+		if(vertices.size() < 2)
+			return;
+		tree cut_tree;
+		sort_preorder(vertices, cut_tree.vertices);
+		for(auto vertex = cut_tree.vertices.rbegin(); vertex != cut_tree.vertices.rend(); ++vertex)
+			accumulate_subtree(*vertex);
+		size_t root = cut_tree.vertices.front();
+		double tree_deviation = get_deviation(sizes[root], sums.data() + root * attribute_size, square_sums.data() + root * attribute_size);
+		std::vector<double> other_sums(attribute_size);
+		std::vector<double> other_square_sums(attribute_size);
+		bool has_cut = false;
+		for(size_t index = 1; index < cut_tree.vertices.size(); ++index) {
+			size_t vertex = cut_tree.vertices[index];
+			for(size_t attribute = 0; attribute < attribute_size; ++attribute) {
+				other_sums[attribute] = sums[root * attribute_size + attribute] - sums[vertex * attribute_size + attribute];
+				other_square_sums[attribute] = square_sums[root * attribute_size + attribute] - square_sums[vertex * attribute_size + attribute];
+			}
+			double gain = tree_deviation - get_deviation(sizes[vertex], sums.data() + vertex * attribute_size, square_sums.data() + vertex * attribute_size) - get_deviation(sizes[root] - sizes[vertex], other_sums.data(), other_square_sums.data());
+			if(!has_cut || gain > cut_tree.cut_gain) {
+				has_cut = true;
+				cut_tree.cut_vertex = index;
+				cut_tree.cut_gain = gain;
+			}
+		}
+		size_t cut_vertex = cut_tree.vertices[cut_tree.cut_vertex];
+		for(const adjacent_type &adjacent : adjacents[cut_vertex])
+			if(!removed_edges[adjacent.second] && adjacent.first == parents[cut_vertex])
+				cut_tree.cut_edge = adjacent.second;
+		trees.push(std::move(cut_tree));
+	}
+
+	void sort_preorder(const vertex_container_type &vertices, vertex_container_type &preorder_vertices) {
+		size_t root = *std::min_element(vertices.begin(), vertices.end());
+		preorder_vertices.reserve(vertices.size());
+		vertex_container_type stack(1, root);
+		parents[root] = root;
+		while(!stack.empty()) {
+			size_t vertex = stack.back();
+			stack.pop_back();
+			preorder_vertices.push_back(vertex);
+			for(auto adjacent = adjacents[vertex].rbegin(); adjacent != adjacents[vertex].rend(); ++adjacent)
+				if(!removed_edges[adjacent->second] && adjacent->first != parents[vertex]) {
+					parents[adjacent->first] = vertex;
+					stack.push_back(adjacent->first);
+				}
+		}
+	}
+
+	void accumulate_subtree(size_t vertex) {
+		sizes[vertex] = 1;
+		for(size_t attribute = 0; attribute < attribute_size; ++attribute) {
+			double value = attributes[vertex * attribute_size + attribute];
+			sums[vertex * attribute_size + attribute] = value;
+			square_sums[vertex * attribute_size + attribute] = value * value;
+		}
+		for(const adjacent_type &adjacent : adjacents[vertex]) {
+			size_t child = adjacent.first;
+			if(removed_edges[adjacent.second] || child == parents[vertex])
+				continue;
+			sizes[vertex] += sizes[child];
+			for(size_t attribute = 0; attribute < attribute_size; ++attribute) {
+				sums[vertex * attribute_size + attribute] += sums[child * attribute_size + attribute];
+				square_sums[vertex * attribute_size + attribute] += square_sums[child * attribute_size + attribute];
+			}
+		}
+	}
+
+	double get_deviation(size_t size, const double *sums, const double *square_sums) const {
+		double deviation = 0;
+		for(size_t attribute = 0; attribute < attribute_size; ++attribute)
+			deviation += square_sums[attribute] - sums[attribute] * sums[attribute] / size;
+		return deviation;
+	}
+
+	/**
+	 * The subtree of the cut vertex is contiguous in the preorder of the tree.
+	 */
+	void split_tree(const tree &cut_tree, vertex_container_type &subtree_vertices, vertex_container_type &other_vertices) const {
+		auto subtree_begin = cut_tree.vertices.begin() + cut_tree.cut_vertex;
+		auto subtree_end = subtree_begin + sizes[*subtree_begin];
+		subtree_vertices.assign(subtree_begin, subtree_end);
+		other_vertices.assign(cut_tree.vertices.begin(), subtree_begin);
+		other_vertices.insert(other_vertices.end(), subtree_end, cut_tree.vertices.end());
+	}
+
+	zone_fusion_step_container_type get_fusion_steps(const std::vector<size_t> &cut_edges) const {
+		vertex_container_type roots(vertex_size);
+		std::iota(roots.begin(), roots.end(), size_t(0));
+		vertex_container_type zones(roots);
+		zone_fusion_step_container_type zone_fusion_steps;
+		zone_fusion_steps.reserve(cut_edges.size());
+		for(size_t index = cut_edges.size(); index-- > 0;) {
+			const spanning_tree_edge &edge = forest_edges[cut_edges[index]];
+			size_t root1 = find_root(roots, edge.vertex1);
+			size_t root2 = find_root(roots, edge.vertex2);
+			zone_fusion_steps.push_back(zone_fusion_step(zones[root1], zones[root2], cut_gains[index]));
+			roots[root2] = root1;
+			zones[root1] = vertex_size + zone_fusion_steps.size() - 1;
+		}
+		return zone_fusion_steps;
+	}
+};
+
+} // namespace geofis
+
+#endif /* SPANNING_TREE_PARTITION_HPP_ */
@@ -0,0 +1,155 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef DELAUNAY_VORONOI_HPP_
+#define DELAUNAY_VORONOI_HPP_
+
+#include <vector>
+#include <utility>
+#include <boost/range.hpp>
+#include <boost/noncopyable.hpp>
+#include <CGAL/Unique_hash_map.h>
+
+namespace geofis {
+
+/**
+ * Gives the voronoi constructions the triangulation computed with exact predicates and inexact constructions, and
+ * builds on demand its dual voronoi diagram with the exact kernel. The exact triangulation is built only when a
+ * construction asks for it, either with all the sites, or with some sites and their neighbors only: the cell of a site
+ * is bounded by the bisectors with its neighbors, so it is the same in both diagrams.
+ */
+template <class DelaunayTriangulation, class VoronoiDiagram> class delaunay_voronoi : public boost::noncopyable {
+
+public:
+	typedef DelaunayTriangulation delaunay_triangulation_type;
+	typedef VoronoiDiagram voronoi_diagram_type;
+	typedef typename voronoi_diagram_type::Delaunay_graph exact_delaunay_triangulation_type;
+	typedef typename delaunay_triangulation_type::Vertex_handle vertex_handle;
+	typedef typename exact_delaunay_triangulation_type::Vertex_handle exact_vertex_handle;
+
+	delaunay_voronoi(const delaunay_triangulation_type &delaunay) : delaunay(delaunay) {}
+
+	const delaunay_triangulation_type &get_delaunay() const {
+		return delaunay;
+	}
+
+	/**
+	 * Builds the voronoi diagram of all the sites.
+	 */
+	void make_voronoi(voronoi_diagram_type &voronoi) const {
+		exact_delaunay_triangulation_type exact_delaunay;
+		exact_delaunay.set_infinite_vertex(exact_delaunay.tds().copy_tds(delaunay.tds(), delaunay.infinite_vertex(), exact_vertex_converter(delaunay.infinite_vertex()), exact_face_converter()));
+		voronoi_diagram_type(exact_delaunay, true).swap(voronoi);
+	}
+
+	/**
+	 * Builds the voronoi diagram of the finite vertices and of their neighbors, and returns the vertices of the voronoi
+	 * triangulation in the order of the vertices.
+	 */
+	template <class VertexRange> void make_voronoi(const VertexRange &vertices, voronoi_diagram_type &voronoi, std::vector<exact_vertex_handle> &exact_vertices) const {
+		std::vector<std::pair<exact_point_type, info_type>> sites;
+		CGAL::Unique_hash_map<vertex_handle, bool> selected(false);
+		auto select = [&](const vertex_handle &vertex) {
+			if(!delaunay.is_infinite(vertex) && !selected[vertex]) {
+				selected[vertex] = true;
+				sites.emplace_back(get_exact_point(*vertex), vertex->info());
+			}
+		};
+		for(const vertex_handle &vertex : vertices) {
+			select(vertex);
+			auto neighbor = delaunay.incident_vertices(vertex), done(neighbor);
+			if(neighbor != nullptr) {
+				do {
+					select(neighbor);
+				} while(++neighbor != done);
+			}
+		}
+		exact_delaunay_triangulation_type exact_delaunay;
+		exact_delaunay.insert(sites.begin(), sites.end());
+		voronoi_diagram_type(exact_delaunay, true).swap(voronoi);
+		exact_vertices.clear();
+		exact_vertices.reserve(boost::size(vertices));
+		exact_vertex_handle hint;
+		for(const vertex_handle &vertex : vertices) {
+			hint = voronoi.dual().nearest_vertex(get_exact_point(*vertex), hint == exact_vertex_handle() ? typename exact_delaunay_triangulation_type::Face_handle() : hint->face());
+			exact_vertices.push_back(hint);
+		}
+	}
+
+private:
+	typedef typename delaunay_triangulation_type::Vertex vertex_type;
+	typedef typename delaunay_triangulation_type::Face face_type;
+	typedef typename exact_delaunay_triangulation_type::Vertex exact_vertex_type;
+	typedef typename exact_delaunay_triangulation_type::Face exact_face_type;
+	typedef typename exact_delaunay_triangulation_type::Point exact_point_type;
+	typedef typename vertex_type::Info info_type;
+
+	const delaunay_triangulation_type &delaunay;
+
+	static exact_point_type get_exact_point(const vertex_type &vertex) {
+		return exact_point_type(vertex.point().x(), vertex.point().y());
+	}
+
+	struct exact_vertex_converter {
+
+		exact_vertex_converter(const vertex_handle &infinite_vertex) : infinite_vertex(&*infinite_vertex) {}
+
+		exact_vertex_type operator()(const vertex_type &vertex) const {
+			return &vertex == infinite_vertex ? exact_vertex_type() : exact_vertex_type(get_exact_point(vertex));
+		}
+
+		void operator()(const vertex_type &vertex, exact_vertex_type &exact_vertex) const {
+			exact_vertex.info() = vertex.info();
+		}
+
+		const vertex_type *infinite_vertex;
+	};
+
+	struct exact_face_converter {
+
+		exact_face_type operator()(const face_type &) const {
+			return exact_face_type();
+		}
+
+		void operator()(const face_type &, exact_face_type &) const {}
+	};
+};
+
+} // namespace geofis
+
+#endif /* DELAUNAY_VORONOI_HPP_ */
@@ -0,0 +1,309 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FILTERED_VORONOI_CONSTRUCTION_HPP_
+#define FILTERED_VORONOI_CONSTRUCTION_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <boost/noncopyable.hpp>
+#include <CGAL/Bbox_2.h>
+#include <CGAL/Unique_hash_map.h>
+#include <geofis/algorithm/zoning/triangulation/voronoi/face_to_geometry.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/face_to_polygon.hpp>
+
+namespace geofis {
+
+/**
+ * Double precision circumcenter of a Delaunay face, with a bound on its absolute error.
+ * The exact circumcenter is used instead when the face is incident to an exactly computed cell.
+ */
+template <class Point> struct filtered_circumcenter {
+
+	filtered_circumcenter() : x(0), y(0), error(std::numeric_limits<double>::infinity()), exact(false) {}
+
+	double x;
+	double y;
+	double error;
+	bool exact;
+	boost::optional<Point> point;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Builds the Voronoi cells of a Delaunay triangulation with the exact kernel only where it is needed.
+ * A cell is built from the double precision circumcenters of its incident faces when it is bounded, far enough
+ * from the boundary edges to not be clipped, and when its vertices are separated and strictly convex beyond the
+ * rounding error. The other cells (hull, boundary and near degenerate cells) are computed exactly, with the voronoi
+ * diagram of their sites and of their neighbors only, and the faces incident to them use their exact circumcenter in
+ * the neighboring cells, so that adjacent cells share their edges.
+ */
+template <class DelaunayVoronoi, class Polygon, class Progress> class filtered_voronoi_builder : public boost::noncopyable {
+
+	typedef typename DelaunayVoronoi::delaunay_triangulation_type delaunay_triangulation_type;
+	typedef typename DelaunayVoronoi::voronoi_diagram_type voronoi_diagram_type;
+	typedef typename DelaunayVoronoi::exact_vertex_handle exact_vertex_handle;
+	typedef typename delaunay_triangulation_type::Point delaunay_point_type;
+	typedef typename Polygon::Point_2 point_type;
+	typedef typename delaunay_triangulation_type::Vertex_handle vertex_handle;
+	typedef typename delaunay_triangulation_type::Face_handle face_handle;
+	typedef typename delaunay_triangulation_type::Face_circulator face_circulator;
+	typedef typename delaunay_triangulation_type::Finite_vertices_iterator finite_vertex_iterator;
+	typedef typename delaunay_triangulation_type::Finite_faces_iterator finite_face_iterator;
+	typedef filtered_circumcenter<point_type> circumcenter_type;
+	typedef face_to_geometry<face_to_polygon<Polygon> > face_to_geometry_type;
+
+public:
+	filtered_voronoi_builder(const DelaunayVoronoi &delaunay_voronoi, const Polygon &boundary, Progress &progress) : delaunay_voronoi(delaunay_voronoi), delaunay(delaunay_voronoi.get_delaunay()), progress(progress), exact_face_to_geometry(make_face_to_polygon(boundary)), indices(0, delaunay.number_of_faces()) {
+		initialize_boundary_boxes(boundary);
+	}
+
+	void operator()() {
+		if(delaunay.dimension() < 2) {
+			voronoi_diagram_type voronoi;
+			delaunay_voronoi.make_voronoi(voronoi);
+			for(auto face = voronoi.faces_begin(); face != voronoi.faces_end(); ++face) {
+				exact_face_to_geometry(*face);
+				progress.step();
+			}
+		} else {
+			initialize_circumcenters();
+			classify_cells();
+			build_exact_cells();
+			build_filtered_cells();
+		}
+	}
+
+private:
+	// beyond this ratio between the magnitude and the value of the orientation determinant, the face is computed exactly
+	static constexpr double max_condition = 1e6;
+	// safety factor applied on the first order rounding error bounds
+	static constexpr double error_factor = 16;
+
+	const DelaunayVoronoi &delaunay_voronoi;
+	const delaunay_triangulation_type &delaunay;
+	Progress &progress;
+	face_to_geometry_type exact_face_to_geometry;
+	std::vector<CGAL::Bbox_2> boundary_boxes;
+	CGAL::Unique_hash_map<face_handle, std::size_t> indices;
+	std::vector<circumcenter_type> circumcenters;
+	std::vector<vertex_handle> exact_vertices;
+	std::vector<vertex_handle> filtered_vertices;
+	std::vector<const circumcenter_type *> cell;
+
+	static double epsilon() {
+		return std::numeric_limits<double>::epsilon();
+	}
+
+	void initialize_boundary_boxes(const Polygon &boundary) {
+		boundary_boxes.reserve(boundary.size());
+		for(typename Polygon::Edge_const_iterator edge = boundary.edges_begin(); edge != boundary.edges_end(); ++edge)
+			boundary_boxes.push_back(edge->bbox());
+	}
+
+	void initialize_circumcenters() {
+		circumcenters.resize(delaunay.number_of_faces());
+		std::size_t index = 0;
+		for(finite_face_iterator face = delaunay.finite_faces_begin(); face != delaunay.finite_faces_end(); ++face, ++index) {
+			indices[face] = index;
+			initialize_circumcenter(face, circumcenters[index]);
+		}
+	}
+
+	/**
+	 * The circumcenter is computed from the lexicographically smallest vertex of the face, so that the same face of
+	 * another triangulation, whose vertices may be rotated, has the same circumcenter.
+	 */
+	static void initialize_circumcenter(const face_handle &face, circumcenter_type &circumcenter) {
+		int origin = 0;
+		for(int index = 1; index < 3; ++index)
+			if(face->vertex(index)->point() < face->vertex(origin)->point())
+				origin = index;
+		const delaunay_point_type &p = face->vertex(face->ccw(origin))->point();
+		const delaunay_point_type &q = face->vertex(face->cw(origin))->point();
+		const delaunay_point_type &r = face->vertex(origin)->point();
+		double rx = CGAL::to_double(r.x()), ry = CGAL::to_double(r.y());
+		double ax = CGAL::to_double(p.x()) - rx, ay = CGAL::to_double(p.y()) - ry;
+		double bx = CGAL::to_double(q.x()) - rx, by = CGAL::to_double(q.y()) - ry;
+		double determinant = ax * by - ay * bx;
+		double magnitude = std::abs(ax * by) + std::abs(ay * bx);
+		if(!(std::abs(determinant) * max_condition > magnitude))
+			return;
+		double a2 = ax * ax + ay * ay, b2 = bx * bx + by * by;
+		double denominator = 2 * determinant;
+		double ux = (by * a2 - ay * b2) / denominator;
+		double uy = (ax * b2 - bx * a2) / denominator;
+		double spread = (std::abs(by) * a2 + std::abs(ay) * b2 + std::abs(ax) * b2 + std::abs(bx) * a2) / std::abs(denominator);
+		double condition = magnitude / std::abs(determinant);
+		circumcenter.x = rx + ux;
+		circumcenter.y = ry + uy;
+		circumcenter.error = error_factor * epsilon() * (spread * (1 + condition) + std::abs(circumcenter.x) + std::abs(circumcenter.y));
+	}
+
+	void classify_cells() {
+		for(finite_vertex_iterator vertex = delaunay.finite_vertices_begin(); vertex != delaunay.finite_vertices_end(); ++vertex) {
+			if(is_filtered_cell(vertex))
+				filtered_vertices.push_back(vertex);
+			else {
+				exact_vertices.push_back(vertex);
+				set_exact_circumcenters(vertex);
+			}
+		}
+	}
+
+	bool is_filtered_cell(const vertex_handle &vertex) {
+		cell.clear();
+		face_circulator face = delaunay.incident_faces(vertex), done(face);
+		do {
+			if(delaunay.is_infinite(face))
+				return false;
+			cell.push_back(&circumcenters[indices[face]]);
+		} while(++face != done);
+		return are_separated() && is_convex() && is_away_from_boundary();
+	}
+
+	bool are_separated() const {
+		for(std::size_t i = 0, size = cell.size(); i < size; ++i) {
+			const circumcenter_type &current = *cell[i], &next = *cell[(i + 1) % size];
+			double separation = std::abs(next.x - current.x) + std::abs(next.y - current.y);
+			if(!(separation > 2 * (current.error + next.error)))
+				return false;
+		}
+		return true;
+	}
+
+	bool is_convex() const {
+		for(std::size_t i = 0, size = cell.size(); i < size; ++i) {
+			const circumcenter_type &previous = *cell[(i + size - 1) % size], &current = *cell[i], &next = *cell[(i + 1) % size];
+			double ux = current.x - previous.x, uy = current.y - previous.y;
+			double vx = next.x - current.x, vy = next.y - current.y;
+			double u = std::abs(ux) + std::abs(uy), v = std::abs(vx) + std::abs(vy);
+			double margin = 4 * (u + v) * (previous.error + current.error + next.error) + error_factor * epsilon() * u * v;
+			if(!(ux * vy - uy * vx > margin))
+				return false;
+		}
+		return true;
+	}
+
+	bool is_away_from_boundary() const {
+		double error = 0, xmin = cell.front()->x, xmax = xmin, ymin = cell.front()->y, ymax = ymin;
+		for(const circumcenter_type *circumcenter : cell) {
+			error = std::max(error, circumcenter->error);
+			xmin = std::min(xmin, circumcenter->x);
+			xmax = std::max(xmax, circumcenter->x);
+			ymin = std::min(ymin, circumcenter->y);
+			ymax = std::max(ymax, circumcenter->y);
+		}
+		CGAL::Bbox_2 box(xmin - 2 * error, ymin - 2 * error, xmax + 2 * error, ymax + 2 * error);
+		for(const CGAL::Bbox_2 &boundary_box : boundary_boxes)
+			if(CGAL::do_overlap(box, boundary_box))
+				return false;
+		return true;
+	}
+
+	void set_exact_circumcenters(const vertex_handle &vertex) {
+		face_circulator face = delaunay.incident_faces(vertex), done(face);
+		do {
+			if(!delaunay.is_infinite(face))
+				circumcenters[indices[face]].exact = true;
+		} while(++face != done);
+	}
+
+	void build_exact_cells() {
+		if(exact_vertices.empty())
+			return;
+		voronoi_diagram_type voronoi;
+		std::vector<exact_vertex_handle> voronoi_vertices;
+		delaunay_voronoi.make_voronoi(exact_vertices, voronoi, voronoi_vertices);
+		for(const exact_vertex_handle &vertex : voronoi_vertices) {
+			exact_face_to_geometry(*voronoi.dual(vertex));
+			progress.step();
+		}
+	}
+
+	void build_filtered_cells() {
+		for(const vertex_handle &vertex : filtered_vertices) {
+			vertex->info().set_geometry(get_filtered_polygon(vertex));
+			progress.step();
+		}
+	}
+
+	Polygon get_filtered_polygon(const vertex_handle &vertex) {
+		Polygon polygon;
+		face_circulator face = delaunay.incident_faces(vertex), done(face);
+		do {
+			polygon.push_back(get_circumcenter_point(face));
+		} while(++face != done);
+		return polygon;
+	}
+
+	point_type get_circumcenter_point(const face_handle &face) {
+		circumcenter_type &circumcenter = circumcenters[indices[face]];
+		if(!circumcenter.exact)
+			return point_type(circumcenter.x, circumcenter.y);
+		if(!circumcenter.point)
+			circumcenter.point = CGAL::circumcenter(get_exact_point(face->vertex(0)), get_exact_point(face->vertex(1)), get_exact_point(face->vertex(2)));
+		return *circumcenter.point;
+	}
+
+	static point_type get_exact_point(const vertex_handle &vertex) {
+		return point_type(vertex->point().x(), vertex->point().y());
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct filtered_voronoi_construction {
+
+	template <class DelaunayVoronoi, class Polygon, class Progress> void operator()(const DelaunayVoronoi &delaunay_voronoi, const Polygon &boundary, Progress &progress) const {
+		filtered_voronoi_builder<DelaunayVoronoi, Polygon, Progress> builder(delaunay_voronoi, boundary, progress);
+		builder();
+	}
+
+	bool operator==(const filtered_voronoi_construction &) const {
+		return true;
+	}
+};
+
+} // namespace geofis
+
+#endif /* FILTERED_VORONOI_CONSTRUCTION_HPP_ */
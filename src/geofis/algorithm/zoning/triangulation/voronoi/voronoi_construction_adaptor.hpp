@@ -0,0 +1,97 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef VORONOI_CONSTRUCTION_ADAPTOR_HPP_
+#define VORONOI_CONSTRUCTION_ADAPTOR_HPP_
+
+#include <boost/variant/is_variant.hpp>
+#include <boost/variant/static_visitor.hpp>
+#include <boost/variant/apply_visitor.hpp>
+
+namespace geofis {
+
+template <class Construction, class IsVariant = typename boost::is_variant<Construction>::type> struct voronoi_construction_adaptor;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Construction> struct voronoi_construction_adaptor<Construction, boost::false_type> {
+
+	voronoi_construction_adaptor(const Construction &construction) : construction(construction) {}
+
+	template <class DelaunayVoronoi, class Polygon, class Progress> void operator() (const DelaunayVoronoi &delaunay_voronoi, const Polygon &boundary, Progress &progress) const {
+		construction(delaunay_voronoi, boundary, progress);
+	}
+
+	Construction construction;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class VariantConstruction> struct voronoi_construction_adaptor<VariantConstruction, boost::true_type> {
+
+	voronoi_construction_adaptor(const VariantConstruction &variant_construction) : variant_construction(variant_construction) {}
+
+	template <class DelaunayVoronoi, class Polygon, class Progress> void operator() (const DelaunayVoronoi &delaunay_voronoi, const Polygon &boundary, Progress &progress) const {
+		boost::apply_visitor(construction_visitor<DelaunayVoronoi, Polygon, Progress>(delaunay_voronoi, boundary, progress), variant_construction);
+	}
+
+	template <class DelaunayVoronoi, class Polygon, class Progress> struct construction_visitor : public boost::static_visitor<> {
+
+		construction_visitor(const DelaunayVoronoi &delaunay_voronoi, const Polygon &boundary, Progress &progress) : delaunay_voronoi(delaunay_voronoi), boundary(boundary), progress(progress) {}
+
+		template <class Construction> void operator() (const Construction &construction) const {
+			construction(delaunay_voronoi, boundary, progress);
+		}
+
+		const DelaunayVoronoi &delaunay_voronoi;
+		const Polygon &boundary;
+		Progress &progress;
+	};
+
+	VariantConstruction variant_construction;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Construction> voronoi_construction_adaptor<Construction> make_voronoi_construction_adaptor(const Construction &construction) {
+	return voronoi_construction_adaptor<Construction>(construction);
+}
+
+} // namespace geofis
+
+#endif /* VORONOI_CONSTRUCTION_ADAPTOR_HPP_ */
@@ -42,15 +42,20 @@
 #include <vector>
 #include <boost/type_traits/add_const.hpp>
 #include <boost/utility.hpp>
-#include <boost/range/sub_range.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <util/assert.hpp>
 #include <util/range/assign.hpp>
+#include <util/range/permuted_range.hpp>
+#include <util/progress/progress_monitor.hpp>
+#include <geofis/identifiable/identifiable_order.hpp>
 #include <geofis/geometry/geometrical.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_zone_traits.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_traits.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_info.hpp>
-#include <geofis/algorithm/zoning/triangulation/voronoi/face_to_geometry.hpp>
-#include <geofis/algorithm/zoning/triangulation/voronoi/face_to_polygon.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/delaunay_voronoi.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/exact_voronoi_construction.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_construction_adaptor.hpp>
 
 namespace geofis {
 
@@ -59,6 +64,18 @@ template <class Kernel, class Feature> struct voronoi_map_traits {
 	typedef typename voronoi_zone_traits<Kernel, Feature>::voronoi_zone_type voronoi_zone_type;
 	typedef voronoi_info_policy<voronoi_zone_type> voronoi_info_policy_type;
 	typedef typename boost::add_const<voronoi_info_policy_type>::type default_info_policy_type;
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel triangulation_kernel_type;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Point> struct point_approximation {
+
+	typedef Point result_type;
+
+	template <class InputPoint> result_type operator()(const InputPoint &point) const {
+		return result_type(CGAL::to_double(point.x()), CGAL::to_double(point.y()));
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -68,43 +85,93 @@ template <class Kernel, class Feature, class InfoPolicy = typename voronoi_map_t
 	typedef typename voronoi_zone_traits<Kernel, Feature>::geometry_type geometry_type;
 	typedef typename voronoi_zone_traits<Kernel, Feature>::voronoi_zone_type voronoi_zone_type;
 	typedef typename InfoPolicy::info_type info_type;
-	typedef typename voronoi_traits<Kernel, info_type>::delaunay_triangulation_type delaunay_triangulation_type;
+	typedef typename voronoi_map_traits<Kernel, Feature>::triangulation_kernel_type triangulation_kernel_type;
+	typedef typename delaunay_traits<triangulation_kernel_type, info_type>::delaunay_triangulation_type delaunay_triangulation_type;
 	typedef typename voronoi_traits<Kernel, info_type>::voronoi_diagram_type voronoi_diagram_type;
+	typedef delaunay_voronoi<delaunay_triangulation_type, voronoi_diagram_type> delaunay_voronoi_type;
 	typedef typename delaunay_triangulation_type::Finite_edges_iterator finite_edge_iterator;
 	typedef std::vector<voronoi_zone_type> zone_container_type;
+	typedef std::vector<size_t> zone_order_type;
 
 public:
-	typedef typename boost::sub_range<const zone_container_type>::type const_zone_range_type;
+	typedef typename util::permuted_range_traits<const zone_container_type, zone_order_type>::permuted_range_type const_zone_range_type;
 	typedef typename boost::iterator_range<finite_edge_iterator> finite_edge_range_type;
+	typedef typename delaunay_triangulation_type::Vertex_handle vertex_handle_type;
+
+	template <class FeatureRange, class Construction, class Progress> void initialize(const FeatureRange &features, const geometry_type &boundary, InfoPolicy &info_policy, const Construction &construction, Progress &progress) {
+		initialize(make_voronoi_zone_range<geometry_type>(features), features, boundary, info_policy, construction, progress);
+	}
+
+	template <class FeatureRange, class Construction> void initialize(const FeatureRange &features, const geometry_type &boundary, InfoPolicy &info_policy, const Construction &construction) {
+		util::null_progress progress;
+		initialize(features, boundary, info_policy, construction, progress);
+	}
 
 	template <class FeatureRange> void initialize(const FeatureRange &features, const geometry_type &boundary, InfoPolicy &info_policy) {
-		initialize(make_voronoi_zone_range<geometry_type>(features), features, boundary, info_policy);
+		initialize(features, boundary, info_policy, exact_voronoi_construction());
 	}
 
 	template <class FeatureRange> void initialize(const FeatureRange &features, const geometry_type &boundary) {
 		initialize(features, boundary, InfoPolicy());
 	}
 
+	/**
+	 * Restores the map from the zone geometries sorted by id, the voronoi diagram is not computed.
+	 */
+	template <class FeatureRange, class GeometryRange> void restore(const FeatureRange &features, const GeometryRange &geometries, InfoPolicy &info_policy) {
+		UTIL_REQUIRE(boost::size(features) == boost::size(geometries));
+		util::assign(zones, make_voronoi_zone_range<geometry_type>(features));
+		zone_order = make_identifiable_order(zones);
+		initialize_delaunay(features, info_policy);
+		auto geometry = boost::begin(geometries);
+		for(size_t zone_index : zone_order)
+			zones[zone_index].set_geometry(*geometry++);
+		initialize_zone_areas();
+	}
+
 	size_t size() const { return zones.size(); }
 
-	const_zone_range_type get_zones() const { return zones; }
+	/**
+	 * The zones are stored in the order of the features, they are returned sorted by id.
+	 */
+	const_zone_range_type get_zones() const { return util::make_permuted_range(zones, zone_order); }
 
 	finite_edge_range_type get_finite_edges() const {
 		return boost::make_iterator_range(delaunay.finite_edges_begin(), delaunay.finite_edges_end());
 	}
 
+	/**
+	 * Returns the zone whose site is the nearest to a point, that is the zone containing the point when it is inside
+	 * the boundary. The point is located in the triangulation by walking from the hint vertex, which is set to the
+	 * nearest vertex, so the consecutive points of a scanline are located in nearly constant time.
+	 */
+	const voronoi_zone_type &locate_zone(double x, double y, vertex_handle_type &hint) const {
+		typedef typename delaunay_triangulation_type::Face_handle face_handle_type;
+		hint = delaunay.nearest_vertex(typename triangulation_kernel_type::Point_2(x, y), hint == vertex_handle_type() ? face_handle_type() : hint->face());
+		return hint->info().get_voronoi_zone();
+	}
+
 private:
 	zone_container_type zones;
+	zone_order_type zone_order;
 	delaunay_triangulation_type delaunay;
 
-	template <class ZoneRange, class FeatureRange> void initialize(const ZoneRange &zones, const FeatureRange &features, const geometry_type &boundary, InfoPolicy &info_policy) {
+	template <class ZoneRange, class FeatureRange, class Construction, class Progress> void initialize(const ZoneRange &zones, const FeatureRange &features, const geometry_type &boundary, InfoPolicy &info_policy, const Construction &construction, Progress &progress) {
 		util::assign(this->zones, zones);
+		zone_order = make_identifiable_order(this->zones);
 		initialize_delaunay(features, info_policy);
-		initialize_zone_geometries_with_voronoi(boundary);
+		initialize_zone_geometries_with_voronoi(boundary, construction, progress);
+		initialize_zone_areas();
 	}
 
+	/**
+	 * The points are inserted sorted by id whatever the storage order of the features: the spatial sort of the
+	 * triangulation shuffles its input, so this keeps the triangulation of degenerate configurations reproducible.
+	 */
 	template <class FeatureRange> void initialize_delaunay(const FeatureRange &features, InfoPolicy &info_policy) {
-		initialize_delaunay_with_infos(make_geometry_range(features), info_policy.make_info_range(zones));
+		auto geometries = make_geometry_range(features) | boost::adaptors::transformed(point_approximation<typename triangulation_kernel_type::Point_2>());
+		auto infos = info_policy.make_info_range(zones);
+		initialize_delaunay_with_infos(util::make_permuted_range(geometries, zone_order), util::make_permuted_range(infos, zone_order));
 	}
 
 	template <class GeometryRange, class InfoRange> void initialize_delaunay_with_infos(const GeometryRange &geometries, const InfoRange &infos) {
@@ -112,12 +179,17 @@ private:
 		delaunay.insert(boost::make_zip_iterator(boost::make_tuple(boost::begin(geometries), boost::begin(infos))), boost::make_zip_iterator(boost::make_tuple(boost::end(geometries), boost::end(infos))));
 	}
 
-	void initialize_zone_geometries_with_voronoi(const geometry_type &boundary) {
-		initialize_zone_geometries_with_voronoi(voronoi_diagram_type(delaunay), boundary);
+	/**
+	 * The triangulation is computed with exact predicates and inexact constructions, the feature coordinates being
+	 * doubles; the construction builds the voronoi diagram with the exact kernel of the sites it needs.
+	 */
+	template <class Construction, class Progress> void initialize_zone_geometries_with_voronoi(const geometry_type &boundary, const Construction &construction, Progress &progress) {
+		make_voronoi_construction_adaptor(construction)(delaunay_voronoi_type(delaunay), boundary, progress);
 	}
 
-	void initialize_zone_geometries_with_voronoi(const voronoi_diagram_type &voronoi, const geometry_type &boundary) {
-		std::for_each(voronoi.faces_begin(), voronoi.faces_end(), make_face_to_geometry(make_face_to_polygon(boundary)));
+	void initialize_zone_areas() {
+		for(voronoi_zone_type &zone : zones)
+			zone.compute_area();
 	}
 };
 
@@ -0,0 +1,232 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef VORONOI_TILING_HPP_
+#define VORONOI_TILING_HPP_
+
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <boost/range.hpp>
+#include <CGAL/Bbox_2.h>
+#include <util/thread/thread_pool.hpp>
+#include <util/progress/progress_monitor.hpp>
+#include <geofis/identifiable/identifiable_order.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_map.hpp>
+
+namespace geofis {
+
+/**
+ * Returns true if the voronoi cell of the site, computed with the sites inside the box only, is the cell computed with
+ * all the sites. The sites are inside the extent, so the sides of the box beyond the extent bound no site.
+ *
+ * The points closer to another site than to the cell site are bounded by a line, so a site outside the box cuts the
+ * cell only if it is closer to a vertex of the cell than the cell site: the disk centered on each vertex and passing
+ * through the site must be inside the box.
+ */
+template <class Geometry> bool is_voronoi_cell_bounded_by_box(const Geometry &cell, double x, double y, const CGAL::Bbox_2 &box, const CGAL::Bbox_2 &extent) {
+	const double infinity = std::numeric_limits<double>::infinity();
+	const double tolerance = 1e-9 * (box.xmax() - box.xmin() + box.ymax() - box.ymin());
+	for(auto vertex = cell.vertices_begin(); vertex != cell.vertices_end(); ++vertex) {
+		double vertex_x = CGAL::to_double(vertex->x());
+		double vertex_y = CGAL::to_double(vertex->y());
+		double clearance = std::min({
+			box.xmin() <= extent.xmin() ? infinity : vertex_x - box.xmin(),
+			box.xmax() >= extent.xmax() ? infinity : box.xmax() - vertex_x,
+			box.ymin() <= extent.ymin() ? infinity : vertex_y - box.ymin(),
+			box.ymax() >= extent.ymax() ? infinity : box.ymax() - vertex_y
+		});
+		if(std::hypot(vertex_x - x, vertex_y - y) + tolerance >= clearance)
+			return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Computes the voronoi geometries of the features clipped by the boundary, tile by tile, and returns them sorted by
+ * feature id.
+ *
+ * The extent of the features is divided into tile_count x tile_count tiles. The cells of the features of a tile are
+ * computed with the features of the tile and of a margin around it, the cells which could be cut by a feature outside
+ * the margin being computed again around them with a margin twice as large. The cells are then those of the whole
+ * voronoi diagram, the tiles being computed concurrently on thread_count threads.
+ *
+ * The tiling only parallelises the construction of the cells, it does not reduce the peak memory: the cells of
+ * all the tiles are kept until they are returned, and the voronoi map restored from them builds the delaunay
+ * triangulation of all the features.
+ *
+ * A cell is taken from a tile only when the cells of its Delaunay neighbors in the tile are bounded by the box too: the
+ * filtered construction computes a cell exactly or in double precision depending on its neighbors, so the cells
+ * sharing an edge in different tiles are computed alike and share the vertices of their edge.
+ *
+ * The tiles are computed with their own copies of the feature locations and of the boundary, made from their double
+ * coordinates, as the exact numbers are not thread safe. The progress counts the features whose cell is computed, it
+ * is reported from the calling thread.
+ */
+template <class Kernel, class FeatureRange, class Geometry, class Construction, class Progress> std::vector<Geometry> compute_tiled_voronoi_geometries(const FeatureRange &features, const Geometry &boundary, const Construction &construction, size_t tile_count, size_t thread_count, Progress &progress) {
+
+	typedef typename boost::range_value<FeatureRange>::type feature_type;
+	typedef typename feature_type::attribute_range_type attribute_range_type;
+	typedef typename Geometry::Point_2 point_type;
+	typedef voronoi_map<Kernel, feature_type> voronoi_map_type;
+	typedef typename voronoi_map_traits<Kernel, feature_type>::voronoi_info_policy_type voronoi_info_policy_type;
+
+	size_t feature_size = boost::size(features);
+	std::vector<Geometry> geometries(feature_size);
+	if(feature_size == 0)
+		return geometries;
+	tile_count = std::max<size_t>(tile_count, 1);
+
+	std::vector<std::pair<double, double>> locations;
+	locations.reserve(feature_size);
+	for(const feature_type &feature : features) {
+		point_type location = feature.get_geometry();
+		locations.emplace_back(CGAL::to_double(location.x()), CGAL::to_double(location.y()));
+	}
+	std::vector<std::pair<double, double>> boundary_vertices;
+	for(auto vertex = boundary.vertices_begin(); vertex != boundary.vertices_end(); ++vertex)
+		boundary_vertices.emplace_back(CGAL::to_double(vertex->x()), CGAL::to_double(vertex->y()));
+
+	CGAL::Bbox_2 extent(locations.front().first, locations.front().second, locations.front().first, locations.front().second);
+	for(const auto &location : locations)
+		extent += CGAL::Bbox_2(location.first, location.second, location.first, location.second);
+	double tile_width = (extent.xmax() - extent.xmin()) / tile_count;
+	double tile_height = (extent.ymax() - extent.ymin()) / tile_count;
+	auto get_tile_index = [tile_count](double coordinate, double origin, double tile_size) {
+		return tile_size > 0 && coordinate > origin ? std::min(size_t((coordinate - origin) / tile_size), tile_count - 1) : 0;
+	};
+	auto get_tile_column = [&](double x) {
+		return get_tile_index(x, extent.xmin(), tile_width);
+	};
+	auto get_tile_row = [&](double y) {
+		return get_tile_index(y, extent.ymin(), tile_height);
+	};
+	std::vector<std::vector<size_t>> tile_features(tile_count * tile_count);
+	std::vector<size_t> tile_of_features(feature_size);
+	for(size_t index = 0; index < feature_size; ++index) {
+		tile_of_features[index] = get_tile_row(locations[index].second) * tile_count + get_tile_column(locations[index].first);
+		tile_features[tile_of_features[index]].push_back(index);
+	}
+	double spacing = std::sqrt((extent.xmax() - extent.xmin()) * (extent.ymax() - extent.ymin()) / feature_size);
+	double initial_margin = std::max(2 * spacing, 1e-9 * (extent.xmax() - extent.xmin() + extent.ymax() - extent.ymin()) + std::numeric_limits<double>::min());
+
+	const double infinity = std::numeric_limits<double>::infinity();
+	std::vector<char> resolved(feature_size, false);
+	std::atomic<size_t> done_feature_size(0);
+	size_t reported_feature_size = 0;
+	std::thread::id calling_thread = std::this_thread::get_id();
+	auto compute_tile = [&](size_t tile) {
+		Geometry tile_boundary;
+		for(const auto &boundary_vertex : boundary_vertices)
+			tile_boundary.push_back(point_type(boundary_vertex.first, boundary_vertex.second));
+		std::vector<size_t> pending_features(tile_features[tile]);
+		for(double margin = initial_margin; !pending_features.empty(); margin *= 2) {
+			CGAL::Bbox_2 box(infinity, infinity, -infinity, -infinity);
+			for(size_t index : pending_features)
+				box += CGAL::Bbox_2(locations[index].first - margin, locations[index].second - margin, locations[index].first + margin, locations[index].second + margin);
+			bool covering = box.xmin() <= extent.xmin() && box.ymin() <= extent.ymin() && box.xmax() >= extent.xmax() && box.ymax() >= extent.ymax();
+			std::vector<size_t> box_features;
+			for(size_t row = get_tile_row(box.ymin()), row_end = get_tile_row(box.ymax()); row <= row_end; ++row) {
+				for(size_t column = get_tile_column(box.xmin()), column_end = get_tile_column(box.xmax()); column <= column_end; ++column) {
+					for(size_t index : tile_features[row * tile_count + column]) {
+						const auto &location = locations[index];
+						if(location.first >= box.xmin() && location.first <= box.xmax() && location.second >= box.ymin() && location.second <= box.ymax())
+							box_features.push_back(index);
+					}
+				}
+			}
+			std::vector<feature_type> tile_map_features;
+			tile_map_features.reserve(box_features.size());
+			for(size_t index : box_features)
+				tile_map_features.push_back(feature_type(boost::begin(features)[index].get_id(), point_type(locations[index].first, locations[index].second), attribute_range_type()));
+			voronoi_map_type tile_map;
+			const voronoi_info_policy_type info_policy = voronoi_info_policy_type();
+			tile_map.initialize(tile_map_features, tile_boundary, info_policy, construction);
+			std::vector<size_t> zone_order = make_identifiable_order(tile_map_features);
+			std::unordered_map<const void *, size_t> box_indices;
+			std::vector<char> bounded(box_features.size());
+			auto zone_order_index = zone_order.begin();
+			for(const auto &zone : tile_map.get_zones()) {
+				size_t box_index = *zone_order_index++;
+				const auto &location = locations[box_features[box_index]];
+				box_indices.emplace(&zone, box_index);
+				bounded[box_index] = covering || is_voronoi_cell_bounded_by_box(zone.get_geometry(), location.first, location.second, box, extent);
+			}
+			std::vector<char> resolvable(bounded);
+			for(const auto &edge : tile_map.get_finite_edges()) {
+				size_t box_index1 = box_indices[&edge.first->vertex(edge.first->cw(edge.second))->info().get_voronoi_zone()];
+				size_t box_index2 = box_indices[&edge.first->vertex(edge.first->ccw(edge.second))->info().get_voronoi_zone()];
+				resolvable[box_index1] = resolvable[box_index1] && bounded[box_index2];
+				resolvable[box_index2] = resolvable[box_index2] && bounded[box_index1];
+			}
+			zone_order_index = zone_order.begin();
+			for(const auto &zone : tile_map.get_zones()) {
+				size_t box_index = *zone_order_index++;
+				size_t index = box_features[box_index];
+				if(tile_of_features[index] == tile && !resolved[index] && resolvable[box_index]) {
+					geometries[index] = zone.get_geometry();
+					resolved[index] = true;
+				}
+			}
+			pending_features.erase(std::remove_if(pending_features.begin(), pending_features.end(), [&resolved](size_t index) { return resolved[index]; }), pending_features.end());
+		}
+		size_t done = done_feature_size += tile_features[tile].size();
+		if(std::this_thread::get_id() == calling_thread) {
+			progress.step(done - reported_feature_size);
+			reported_feature_size = done;
+		}
+	};
+	util::thread_pool(thread_count).run(tile_features.size(), compute_tile);
+
+	std::vector<Geometry> sorted_geometries;
+	sorted_geometries.reserve(feature_size);
+	for(size_t index : make_identifiable_order(features))
+		sorted_geometries.push_back(std::move(geometries[index]));
+	return sorted_geometries;
+}
+
+} // namespace geofis
+
+#endif /* VORONOI_TILING_HPP_ */
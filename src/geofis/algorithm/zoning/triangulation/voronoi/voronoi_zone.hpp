@@ -41,6 +41,7 @@
 
 #include <boost/ref.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <geofis/geometry/area/geometry_area.hpp>
 
 namespace geofis {
 
@@ -51,7 +52,10 @@ title voronoi_zone class diagram
 
 class voronoi_zone<Geometry, Feature> {
 - geometry : Geometry
+- area : double
 + get_id() : id_type
++ get_area() : double
++ compute_area()
 }
 
 hide voronoi_zone methods
@@ -80,7 +84,7 @@ public:
 	typedef typename Feature::id_type id_type;
 	typedef typename Feature::const_attribute_range_type const_attribute_range_type;
 
-	voronoi_zone(const feature_type &feature) : feature(feature) {}
+	voronoi_zone(const feature_type &feature) : feature(feature), area(0) {}
 
 	id_type get_id() const {
 		return feature.get().get_id();
@@ -94,6 +98,18 @@ public:
 		this->geometry = geometry;
 	}
 
+	double get_area() const {
+		return area;
+	}
+
+	/**
+	 * Computes the area of the geometry once in double, the areas of the zones being the sums of the areas of their
+	 * voronoi zones.
+	 */
+	void compute_area() {
+		area = get_double_geometry_area(geometry);
+	}
+
 	const feature_type &get_feature() const {
 		return feature;
 	}
@@ -105,6 +121,7 @@ public:
 private:
 	feature_reference_type feature;
 	geometry_type geometry;
+	double area;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -40,6 +40,7 @@
 #define FEATURE_HPP_
 
 #include <cstddef>
+#include <utility>
 #include <functional>
 #include <boost/variant.hpp>
 #include <boost/mpl/contains.hpp>
@@ -141,6 +142,7 @@ public:
 	typedef typename boost::sub_range<const AttributeRange>::type const_attribute_range_type;
 
 	feature(Id id, const Geometry &geometry, const AttributeRange &attributes) : id(id), geometry(geometry), attributes(attributes) {}
+	feature(Id id, const Geometry &geometry, AttributeRange &&attributes) : id(id), geometry(geometry), attributes(std::move(attributes)) {}
 	template <class OtherAttributeRange> feature(Id id, const Geometry &geometry, const OtherAttributeRange &other_attributes) : id(id), geometry(geometry), attributes(boost::begin(other_attributes), boost::end(other_attributes)) {}
 	template <class OtherAttributeRange> feature(const feature<Id, Geometry, OtherAttributeRange> &other_feature) : id(other_feature.get_id()), geometry(other_feature.get_geometry()), attributes(other_feature.get_attribute_begin(), other_feature.get_attribute_end()) {}
 
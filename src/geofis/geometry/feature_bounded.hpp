@@ -39,28 +39,27 @@
 #ifndef H8B6165AC_994C_42F8_93B4_670248349757
 #define H8B6165AC_994C_42F8_93B4_670248349757
 
-#include <CGAL/Polygon_2.h>
-#include <CGAL/Polygon_2_algorithms.h>
+#include <geofis/geometry/polygon_slab_index.hpp>
 
 namespace geofis {
 
 template <class Kernel> class feature_bounded {
 
-	typedef CGAL::Polygon_2<Kernel> polygon_type;
+	typedef polygon_slab_index<Kernel> polygon_index_type;
 
-	polygon_type border;
+	const polygon_index_type &border;
 
 public:
-	feature_bounded(const polygon_type &border) : border(border) {}
+	feature_bounded(const polygon_index_type &border) : border(border) {}
 
 	template <class Feature> bool operator()(const Feature &feature) const {
-		return CGAL::bounded_side_2(border.vertices_begin(), border.vertices_end(), feature.get_geometry()) != CGAL::ON_UNBOUNDED_SIDE;
+		return border.bounded_side(feature.get_geometry()) != CGAL::ON_UNBOUNDED_SIDE;
 	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <class Kernel> inline feature_bounded<Kernel> make_feature_bounded(const CGAL::Polygon_2<Kernel> &border) {
+template <class Kernel> inline feature_bounded<Kernel> make_feature_bounded(const polygon_slab_index<Kernel> &border) {
 	return feature_bounded<Kernel>(border);
 }
 
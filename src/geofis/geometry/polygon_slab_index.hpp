@@ -0,0 +1,212 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef POLYGON_SLAB_INDEX_HPP_
+#define POLYGON_SLAB_INDEX_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <CGAL/Point_2.h>
+#include <CGAL/Polygon_2.h>
+#include <CGAL/Polygon_2_algorithms.h>
+
+namespace geofis {
+
+/**
+ * Slab decomposition of a simple polygon for batched point containment tests.
+ * The horizontal slabs between consecutive vertex ordinates are built once, each slab holding the edges crossing it
+ * sorted by abscissa, so that a point is classified by a binary search of its slab edges with a filtered double
+ * orientation predicate. The exact CGAL::bounded_side_2 test is used when the double predicate cannot decide (point
+ * near an edge or on a vertex ordinate), or when the coordinates are not exactly representable as doubles.
+ */
+template <class Kernel> class polygon_slab_index {
+
+public:
+	typedef CGAL::Point_2<Kernel> point_type;
+	typedef CGAL::Polygon_2<Kernel> polygon_type;
+
+private:
+	// edge oriented with increasing ordinates
+	struct slab_edge {
+
+		slab_edge() : x1(0), y1(0), x2(0), y2(0) {}
+		slab_edge(double x1, double y1, double x2, double y2) : x1(x1), y1(y1), x2(x2), y2(y2) {}
+
+		double get_abscissa(double y) const {
+			return x1 + (x2 - x1) * ((y - y1) / (y2 - y1));
+		}
+
+		double x1;
+		double y1;
+		double x2;
+		double y2;
+	};
+
+	polygon_type polygon;
+	bool filtered;
+	std::vector<double> ordinates;
+	std::vector<std::size_t> offsets;
+	std::vector<slab_edge> edges;
+	std::vector<bool> ambiguous;
+
+public:
+	polygon_slab_index(const polygon_type &polygon) : polygon(polygon), filtered(true) {
+		initialize_slabs();
+	}
+
+	CGAL::Bounded_side bounded_side(const point_type &point) const {
+		double x, y;
+		if(!filtered || !get_exact_double(point, x, y))
+			return get_exact_bounded_side(point);
+		if(y < ordinates.front() || y > ordinates.back())
+			return CGAL::ON_UNBOUNDED_SIDE;
+		std::size_t slab = std::upper_bound(ordinates.begin(), ordinates.end(), y) - ordinates.begin() - 1;
+		if(ordinates[slab] == y || ambiguous[slab])
+			return get_exact_bounded_side(point);
+		std::size_t begin = offsets[slab], end = offsets[slab + 1];
+		std::size_t lower = begin, upper = end;
+		while(lower < upper) {
+			std::size_t middle = lower + (upper - lower) / 2;
+			int side = get_filtered_side(edges[middle], x, y);
+			if(side == 0)
+				return get_exact_bounded_side(point);
+			if(side < 0)
+				lower = middle + 1;
+			else
+				upper = middle;
+		}
+		return (lower - begin) % 2 ? CGAL::ON_BOUNDED_SIDE : CGAL::ON_UNBOUNDED_SIDE;
+	}
+
+private:
+	static double epsilon() {
+		return std::numeric_limits<double>::epsilon();
+	}
+
+	static bool get_exact_double(const point_type &point, double &x, double &y) {
+		std::pair<double, double> x_interval = CGAL::to_interval(point.x());
+		std::pair<double, double> y_interval = CGAL::to_interval(point.y());
+		x = x_interval.first;
+		y = y_interval.first;
+		return x_interval.first == x_interval.second && y_interval.first == y_interval.second;
+	}
+
+	CGAL::Bounded_side get_exact_bounded_side(const point_type &point) const {
+		return CGAL::bounded_side_2(polygon.vertices_begin(), polygon.vertices_end(), point);
+	}
+
+	// sign of the orientation of the point relatively to the edge, 0 if the double evaluation is not reliable
+	static int get_filtered_side(const slab_edge &edge, double x, double y) {
+		double left = (edge.x2 - edge.x1) * (y - edge.y1);
+		double right = (edge.y2 - edge.y1) * (x - edge.x1);
+		double determinant = left - right;
+		double error = 4 * epsilon() * (std::abs(left) + std::abs(right));
+		if(determinant > error)
+			return 1;
+		if(determinant < -error)
+			return -1;
+		return 0;
+	}
+
+	void initialize_slabs() {
+		std::vector<slab_edge> polygon_edges;
+		for(std::size_t source = 0, size = polygon.size(); source < size; ++source) {
+			double x1, y1, x2, y2;
+			if(!get_exact_double(polygon[source], x1, y1) || !get_exact_double(polygon[(source + 1) % size], x2, y2)) {
+				filtered = false;
+				return;
+			}
+			ordinates.push_back(y1);
+			if(y1 < y2)
+				polygon_edges.push_back(slab_edge(x1, y1, x2, y2));
+			else if(y2 < y1)
+				polygon_edges.push_back(slab_edge(x2, y2, x1, y1));
+		}
+		if(ordinates.empty()) {
+			filtered = false;
+			return;
+		}
+		std::sort(ordinates.begin(), ordinates.end());
+		ordinates.erase(std::unique(ordinates.begin(), ordinates.end()), ordinates.end());
+		initialize_slab_edges(polygon_edges);
+		initialize_ambiguous_slabs();
+	}
+
+	std::size_t get_ordinate_index(double y) const {
+		return std::lower_bound(ordinates.begin(), ordinates.end(), y) - ordinates.begin();
+	}
+
+	void initialize_slab_edges(const std::vector<slab_edge> &polygon_edges) {
+		std::vector<std::size_t> sizes(ordinates.size(), 0);
+		for(const slab_edge &edge : polygon_edges)
+			for(std::size_t slab = get_ordinate_index(edge.y1), last = get_ordinate_index(edge.y2); slab < last; ++slab)
+				++sizes[slab];
+		offsets.assign(ordinates.size(), 0);
+		for(std::size_t slab = 1; slab < ordinates.size(); ++slab)
+			offsets[slab] = offsets[slab - 1] + sizes[slab - 1];
+		edges.resize(offsets.back());
+		std::vector<std::size_t> positions(offsets.begin(), offsets.end() - 1);
+		for(const slab_edge &edge : polygon_edges)
+			for(std::size_t slab = get_ordinate_index(edge.y1), last = get_ordinate_index(edge.y2); slab < last; ++slab)
+				edges[positions[slab]++] = edge;
+	}
+
+	void initialize_ambiguous_slabs() {
+		ambiguous.assign(ordinates.size() - 1, false);
+		for(std::size_t slab = 0; slab + 1 < ordinates.size(); ++slab) {
+			double y = (ordinates[slab] + ordinates[slab + 1]) / 2;
+			typename std::vector<slab_edge>::iterator begin = edges.begin() + offsets[slab], end = edges.begin() + offsets[slab + 1];
+			std::sort(begin, end, [y](const slab_edge &edge1, const slab_edge &edge2) { return edge1.get_abscissa(y) < edge2.get_abscissa(y); });
+			for(typename std::vector<slab_edge>::iterator edge = begin; edge != end && edge + 1 != end; ++edge)
+				if(!are_separated(*edge, *(edge + 1), y))
+					ambiguous[slab] = true;
+		}
+	}
+
+	// the edges of a simple polygon do not cross inside a slab, their order is certified when their abscissas differ beyond the rounding error
+	static bool are_separated(const slab_edge &edge1, const slab_edge &edge2, double y) {
+		double error = 8 * epsilon() * (std::abs(edge1.x1) + std::abs(edge1.x2) + std::abs(edge2.x1) + std::abs(edge2.x2));
+		return edge2.get_abscissa(y) - edge1.get_abscissa(y) > error;
+	}
+};
+
+} // namespace geofis
+
+#endif /* POLYGON_SLAB_INDEX_HPP_ */
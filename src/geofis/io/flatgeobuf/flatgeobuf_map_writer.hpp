@@ -0,0 +1,288 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FLATGEOBUF_MAP_WRITER_HPP_
+#define FLATGEOBUF_MAP_WRITER_HPP_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <boost/range.hpp>
+#include <CGAL/Polygon_2.h>
+#include <CGAL/Polygon_with_holes_2.h>
+#include <util/flatbuffer/flatbuffer_builder.hpp>
+#include <geofis/io/flatgeobuf/packed_hilbert_rtree.hpp>
+
+namespace geofis {
+
+/**
+ * Values of the FlatGeobuf schema used by the map writer.
+ */
+struct flatgeobuf_format {
+
+	static constexpr char magic[8] = { 'f', 'g', 'b', 3, 'f', 'g', 'b', 0 };
+	static constexpr uint16_t index_node_size = 16;
+
+	enum geometry_type : uint8_t { polygon_type = 3 };
+	enum column_type : uint8_t { int_type = 5, double_type = 10, string_type = 11 };
+
+	enum header_field : uint16_t { header_name = 0, header_envelope = 1, header_geometry_type = 2, header_columns = 7, header_features_count = 8, header_index_node_size = 9, header_crs = 10 };
+	enum column_field : uint16_t { column_name = 0, column_type_field = 1 };
+	enum crs_field : uint16_t { crs_wkt = 4 };
+	enum geometry_field : uint16_t { geometry_ends = 0, geometry_xy = 1, geometry_type_field = 6 };
+	enum feature_field : uint16_t { feature_geometry = 0, feature_properties = 1 };
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+
+@startuml
+
+class flatgeobuf_map_writer {
++ flatgeobuf_map_writer(attribute_names : const std::vector<std::string> &, crs_wkt : const std::string &, spatial_index : bool)
++ write<Map>(stream : std::ostream &, map : const Map &, name : const std::string &) : void
+}
+
+@enduml
+
+*/
+
+/**
+ * Writes the maps in the FlatGeobuf format, each zone being a polygon feature with the id, size, area, mean and
+ * standard deviation attributes of the map data frames.
+ *
+ * The features are serialized one by one in a reused buffer and written to the stream, so a map is never held twice
+ * in memory. With the spatial index, the features are stored along the Hilbert curve of their bounding boxes and
+ * are serialized twice: first to get their offsets for the packed rtree written before them, then to be written.
+ */
+class flatgeobuf_map_writer {
+
+	std::vector<std::string> column_names;
+	std::string crs_wkt;
+	bool spatial_index;
+	util::flatbuffer_builder builder;
+	std::vector<uint8_t> properties;
+	std::vector<uint32_t> ends;
+	std::vector<double> coordinates;
+
+public:
+	flatgeobuf_map_writer(const std::vector<std::string> &attribute_names, const std::string &crs_wkt, bool spatial_index) : column_names({ "id", "size", "area" }), crs_wkt(crs_wkt), spatial_index(spatial_index) {
+		for(const std::string &attribute_name : attribute_names) {
+			column_names.push_back(attribute_name + "_mean");
+			column_names.push_back(attribute_name + "_std");
+		}
+	}
+
+	template <class Map> void write(std::ostream &stream, const Map &map, const std::string &name) {
+		auto zone_range = map.get_zones();
+		std::vector<rtree_node> boxes;
+		boxes.reserve(boost::size(zone_range));
+		for(const auto &zone : zone_range)
+			boxes.push_back(get_box(zone.get_geometry().outer_boundary()));
+		std::vector<size_t> order = spatial_index ? get_hilbert_order(boxes) : get_identity_order(boxes.size());
+		rtree_node extent;
+		for(const rtree_node &box : boxes)
+			extent.expand(box);
+		stream.write(flatgeobuf_format::magic, sizeof(flatgeobuf_format::magic));
+		build_header(name, extent, boxes.size(), spatial_index && !boxes.empty());
+		write_buffer(stream);
+		if(spatial_index && !boxes.empty()) {
+			std::vector<rtree_node> leaves;
+			leaves.reserve(boxes.size());
+			uint64_t offset = 0;
+			for(size_t index : order) {
+				leaves.push_back(boxes[index]);
+				leaves.back().offset = offset;
+				build_feature(boost::begin(zone_range)[index]);
+				offset += sizeof(uint32_t) + builder.size();
+			}
+			packed_hilbert_rtree(leaves, flatgeobuf_format::index_node_size).write(stream);
+		}
+		for(size_t index : order) {
+			build_feature(boost::begin(zone_range)[index]);
+			write_buffer(stream);
+		}
+	}
+
+private:
+	static std::vector<size_t> get_identity_order(size_t size) {
+		std::vector<size_t> order(size);
+		for(size_t index = 0; index < size; ++index)
+			order[index] = index;
+		return order;
+	}
+
+	template <class Kernel> static rtree_node get_box(const CGAL::Polygon_2<Kernel> &ring) {
+		rtree_node box;
+		for(auto vertex = ring.vertices_begin(); vertex != ring.vertices_end(); ++vertex)
+			box.expand(CGAL::to_double(vertex->x()), CGAL::to_double(vertex->y()));
+		return box;
+	}
+
+	// writes the size prefixed buffer
+	void write_buffer(std::ostream &stream) {
+		uint8_t size[sizeof(uint32_t)];
+		util::flatbuffer_table::store_little_endian(uint32_t(builder.size()), size);
+		stream.write(reinterpret_cast<const char *>(size), sizeof(size));
+		stream.write(reinterpret_cast<const char *>(builder.get_buffer().data()), builder.size());
+	}
+
+	void build_header(const std::string &name, const rtree_node &extent, size_t feature_size, bool indexed) {
+		builder.clear();
+		size_t root = builder.begin_root();
+		util::flatbuffer_table header;
+		if(!name.empty())
+			header.add_offset(flatgeobuf_format::header_name);
+		if(feature_size)
+			header.add_offset(flatgeobuf_format::header_envelope);
+		header.add_scalar(flatgeobuf_format::header_geometry_type, uint8_t(flatgeobuf_format::polygon_type));
+		header.add_offset(flatgeobuf_format::header_columns);
+		header.add_scalar(flatgeobuf_format::header_features_count, uint64_t(feature_size));
+		header.add_scalar(flatgeobuf_format::header_index_node_size, uint16_t(indexed ? flatgeobuf_format::index_node_size : 0));
+		if(!crs_wkt.empty())
+			header.add_offset(flatgeobuf_format::header_crs);
+		builder.patch_offset(root, builder.write_table(header));
+		if(!name.empty())
+			builder.patch_offset(header.get_position(flatgeobuf_format::header_name), builder.write_string(name));
+		if(feature_size) {
+			std::vector<double> envelope = { extent.min_x, extent.min_y, extent.max_x, extent.max_y };
+			builder.patch_offset(header.get_position(flatgeobuf_format::header_envelope), builder.write_vector(envelope));
+		}
+		size_t columns = builder.write_offset_vector(column_names.size());
+		builder.patch_offset(header.get_position(flatgeobuf_format::header_columns), columns);
+		for(size_t index = 0; index < column_names.size(); ++index) {
+			util::flatbuffer_table column;
+			column.add_offset(flatgeobuf_format::column_name);
+			column.add_scalar(flatgeobuf_format::column_type_field, uint8_t(get_column_type(index)));
+			builder.patch_offset(util::flatbuffer_builder::get_offset_vector_element(columns, index), builder.write_table(column));
+			builder.patch_offset(column.get_position(flatgeobuf_format::column_name), builder.write_string(column_names[index]));
+		}
+		if(!crs_wkt.empty()) {
+			util::flatbuffer_table crs;
+			crs.add_offset(flatgeobuf_format::crs_wkt);
+			builder.patch_offset(header.get_position(flatgeobuf_format::header_crs), builder.write_table(crs));
+			builder.patch_offset(crs.get_position(flatgeobuf_format::crs_wkt), builder.write_string(crs_wkt));
+		}
+		builder.end_root();
+	}
+
+	static flatgeobuf_format::column_type get_column_type(size_t column) {
+		switch(column) {
+		case 0:
+			return flatgeobuf_format::string_type;
+		case 1:
+			return flatgeobuf_format::int_type;
+		default:
+			return flatgeobuf_format::double_type;
+		}
+	}
+
+	template <class Zone> void build_feature(const Zone &zone) {
+		build_geometry(zone.get_geometry());
+		build_properties(zone);
+		builder.clear();
+		size_t root = builder.begin_root();
+		util::flatbuffer_table feature;
+		feature.add_offset(flatgeobuf_format::feature_geometry);
+		feature.add_offset(flatgeobuf_format::feature_properties);
+		builder.patch_offset(root, builder.write_table(feature));
+		util::flatbuffer_table geometry;
+		geometry.add_offset(flatgeobuf_format::geometry_ends);
+		geometry.add_offset(flatgeobuf_format::geometry_xy);
+		geometry.add_scalar(flatgeobuf_format::geometry_type_field, uint8_t(flatgeobuf_format::polygon_type));
+		builder.patch_offset(feature.get_position(flatgeobuf_format::feature_geometry), builder.write_table(geometry));
+		builder.patch_offset(geometry.get_position(flatgeobuf_format::geometry_ends), builder.write_vector(ends));
+		builder.patch_offset(geometry.get_position(flatgeobuf_format::geometry_xy), builder.write_vector(coordinates));
+		builder.patch_offset(feature.get_position(flatgeobuf_format::feature_properties), builder.write_vector(properties));
+		builder.end_root();
+	}
+
+	// the rings are closed, the ends being the cumulated numbers of points of the rings
+	template <class Kernel> void build_ring(const CGAL::Polygon_2<Kernel> &ring) {
+		for(auto vertex = ring.vertices_begin(); vertex != ring.vertices_end(); ++vertex) {
+			coordinates.push_back(CGAL::to_double(vertex->x()));
+			coordinates.push_back(CGAL::to_double(vertex->y()));
+		}
+		coordinates.push_back(coordinates[2 * ends.back()]);
+		coordinates.push_back(coordinates[2 * ends.back() + 1]);
+		ends.push_back(uint32_t(coordinates.size() / 2));
+	}
+
+	template <class Kernel> void build_geometry(const CGAL::Polygon_with_holes_2<Kernel> &polygon_with_holes) {
+		coordinates.clear();
+		ends.assign(1, 0);
+		build_ring(polygon_with_holes.outer_boundary());
+		for(auto hole = polygon_with_holes.holes_begin(); hole != polygon_with_holes.holes_end(); ++hole)
+			build_ring(*hole);
+		ends.erase(ends.begin());
+	}
+
+	template <class Zone> void build_properties(const Zone &zone) {
+		properties.clear();
+		add_property(0, zone.get_id());
+		add_property(1, int32_t(zone.size()));
+		add_property(2, double(zone.get_area()));
+		for(size_t column = 3; column < column_names.size(); column += 2) {
+			add_property(column, double(zone.get_mean((column - 3) / 2)));
+			add_property(column + 1, double(zone.get_standard_deviation((column - 3) / 2)));
+		}
+	}
+
+	template <class T> void add_property(size_t column, T value) {
+		add_property_bytes(uint16_t(column));
+		add_property_bytes(value);
+	}
+
+	void add_property(size_t column, const std::string &value) {
+		add_property_bytes(uint16_t(column));
+		add_property_bytes(uint32_t(value.size()));
+		properties.insert(properties.end(), value.begin(), value.end());
+	}
+
+	template <class T> void add_property_bytes(T value) {
+		size_t position = properties.size();
+		properties.resize(position + sizeof(T));
+		util::flatbuffer_table::store_little_endian(value, properties.data() + position);
+	}
+};
+
+} // namespace geofis
+
+#endif /* FLATGEOBUF_MAP_WRITER_HPP_ */
@@ -0,0 +1,200 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef PACKED_HILBERT_RTREE_HPP_
+#define PACKED_HILBERT_RTREE_HPP_
+
+#include <limits>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <util/assert.hpp>
+#include <util/flatbuffer/flatbuffer_builder.hpp>
+
+namespace geofis {
+
+/**
+ * Node of a packed rtree: the bounding box of the node and the offset of its first child node, or the byte offset
+ * of the feature for a leaf node.
+ */
+struct rtree_node {
+
+	rtree_node(uint64_t offset = 0) : min_x(std::numeric_limits<double>::infinity()), min_y(min_x), max_x(-min_x), max_y(-min_x), offset(offset) {}
+
+	void expand(double x, double y) {
+		min_x = std::min(min_x, x);
+		min_y = std::min(min_y, y);
+		max_x = std::max(max_x, x);
+		max_y = std::max(max_y, y);
+	}
+
+	void expand(const rtree_node &node) {
+		expand(node.min_x, node.min_y);
+		expand(node.max_x, node.max_y);
+	}
+
+	double min_x;
+	double min_y;
+	double max_x;
+	double max_y;
+	uint64_t offset;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the index of a cell of the 2^16 x 2^16 grid along the Hilbert curve.
+ */
+inline uint32_t get_hilbert_index(uint32_t x, uint32_t y) {
+	const uint32_t grid_size = 1u << 16;
+	uint32_t index = 0;
+	for(uint32_t step = grid_size / 2; step > 0; step /= 2) {
+		uint32_t rx = (x & step) > 0;
+		uint32_t ry = (y & step) > 0;
+		index += step * step * ((3 * rx) ^ ry);
+		if(ry == 0) {
+			if(rx == 1) {
+				x = grid_size - 1 - x;
+				y = grid_size - 1 - y;
+			}
+			std::swap(x, y);
+		}
+	}
+	return index;
+}
+
+/**
+ * Returns the order of the boxes along the Hilbert curve of their centers, the curve covering the extent of the boxes.
+ */
+inline std::vector<size_t> get_hilbert_order(const std::vector<rtree_node> &boxes) {
+	rtree_node extent;
+	for(const rtree_node &box : boxes)
+		extent.expand(box);
+	const double hilbert_max = (1u << 16) - 1;
+	double width = extent.max_x - extent.min_x;
+	double height = extent.max_y - extent.min_y;
+	std::vector<uint32_t> hilbert_indices;
+	hilbert_indices.reserve(boxes.size());
+	for(const rtree_node &box : boxes) {
+		uint32_t x = width > 0 ? uint32_t(std::floor(hilbert_max * ((box.min_x + box.max_x) / 2 - extent.min_x) / width)) : 0;
+		uint32_t y = height > 0 ? uint32_t(std::floor(hilbert_max * ((box.min_y + box.max_y) / 2 - extent.min_y) / height)) : 0;
+		hilbert_indices.push_back(get_hilbert_index(x, y));
+	}
+	std::vector<size_t> order(boxes.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&hilbert_indices](size_t index1, size_t index2) { return hilbert_indices[index1] < hilbert_indices[index2]; });
+	return order;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Packed Hilbert rtree of the FlatGeobuf format.
+ *
+ * The leaves are the boxes of the features in their storage order, which is expected to follow the Hilbert curve.
+ * The nodes of each level group node_size nodes of the level below, and the levels are stored from the root down to
+ * the leaves, an inner node referring to its first child by its index.
+ */
+class packed_hilbert_rtree {
+
+	typedef std::pair<size_t, size_t> level_bound_type;
+
+	std::vector<rtree_node> nodes;
+
+public:
+	packed_hilbert_rtree(const std::vector<rtree_node> &leaves, uint16_t node_size) {
+		UTIL_REQUIRE(!leaves.empty() && node_size >= 2);
+		std::vector<level_bound_type> level_bounds = get_level_bounds(leaves.size(), node_size);
+		nodes.resize(level_bounds.front().second);
+		std::copy(leaves.begin(), leaves.end(), nodes.begin() + level_bounds.front().first);
+		for(size_t level = 0; level + 1 < level_bounds.size(); ++level) {
+			size_t position = level_bounds[level].first;
+			size_t end = level_bounds[level].second;
+			size_t parent_position = level_bounds[level + 1].first;
+			while(position < end) {
+				rtree_node node(position);
+				for(size_t child = 0; child < node_size && position < end; ++child)
+					node.expand(nodes[position++]);
+				nodes[parent_position++] = node;
+			}
+		}
+	}
+
+	const rtree_node &get_extent() const {
+		return nodes.front();
+	}
+
+	void write(std::ostream &stream) const {
+		uint8_t bytes[sizeof(double) * 4 + sizeof(uint64_t)];
+		for(const rtree_node &node : nodes) {
+			util::flatbuffer_table::store_little_endian(node.min_x, bytes);
+			util::flatbuffer_table::store_little_endian(node.min_y, bytes + 8);
+			util::flatbuffer_table::store_little_endian(node.max_x, bytes + 16);
+			util::flatbuffer_table::store_little_endian(node.max_y, bytes + 24);
+			util::flatbuffer_table::store_little_endian(node.offset, bytes + 32);
+			stream.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+		}
+	}
+
+private:
+	// the bounds of the levels, from the leaves up to the root, in the storage order of the nodes
+	static std::vector<level_bound_type> get_level_bounds(size_t item_size, size_t node_size) {
+		std::vector<size_t> level_sizes(1, item_size);
+		size_t node_count = item_size;
+		size_t level_size = item_size;
+		do {
+			level_size = (level_size + node_size - 1) / node_size;
+			level_sizes.push_back(level_size);
+			node_count += level_size;
+		} while(level_size != 1);
+		std::vector<level_bound_type> level_bounds;
+		for(size_t size : level_sizes) {
+			node_count -= size;
+			level_bounds.push_back(level_bound_type(node_count, node_count + size));
+		}
+		return level_bounds;
+	}
+};
+
+} // namespace geofis
+
+#endif /* PACKED_HILBERT_RTREE_HPP_ */
@@ -45,7 +45,11 @@ namespace geofis {
 
 fusion_process::fusion_process() : impl(nullptr) {}
 
-fusion_process::fusion_process(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors) : impl(new fusion_process_impl(aggregation, zone_distance, multidimensional_distance, attribute_distances, features, zone_neighbors)) {}
+fusion_process::fusion_process(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) : impl(new fusion_process_impl(aggregation, fusion_strategy, zone_distance, multidimensional_distance, attribute_distances, features, zone_neighbors, progress)) {}
+
+fusion_process::fusion_process(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) : impl(new fusion_process_impl(aggregation, fusion_strategy, zone_distance, multidimensional_distance, attribute_distances, zone_neighbors, progress)) {}
+
+fusion_process::fusion_process(const aggregation_type &aggregation, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps) : impl(new fusion_process_impl(aggregation, attribute_distances, features, zones, zone_fusion_steps)) {}
 
 fusion_process::~fusion_process() {}
 
@@ -58,8 +62,24 @@ size_t fusion_process::get_fusion_size() const {
 	return impl->get_fusion_size();
 }
 
+size_t fusion_process::get_cut_fusion_size(double distance) const {
+	return impl->get_cut_fusion_size(distance);
+}
+
 fusion_process::fusion_map_range_type fusion_process::get_fusion_maps(zone_info_policy_type &zones, size_t begin, size_t end, bool compute_zones) {
 	return impl->get_fusion_maps(zones, begin, end, compute_zones);
 }
 
+fusion_process::zone_fusion_step_container_type fusion_process::get_fusion_steps(const zone_info_policy_type &zones) const {
+	return impl->get_fusion_steps(zones);
+}
+
+void fusion_process::normalize_features(feature_range_type &features) {
+	fusion_process_impl::normalize_features(features);
+}
+
+void fusion_process::normalize_attribute_distances(attribute_distance_range_type &attribute_distances) {
+	fusion_process_impl::normalize_attribute_distances(attribute_distances);
+}
+
 } // namespace geofis
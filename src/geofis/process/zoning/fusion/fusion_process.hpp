@@ -49,13 +49,16 @@ class fusion_process_impl;
 class fusion_process {
 
 	typedef fusion_process_traits::aggregation_type aggregation_type;
+	typedef fusion_process_traits::fusion_strategy_type fusion_strategy_type;
 	typedef fusion_process_traits::zone_distance_type zone_distance_type;
 	typedef fusion_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef fusion_process_traits::attribute_distance_range_type attribute_distance_range_type;
 	typedef fusion_process_traits::feature_range_type feature_range_type;
 	typedef fusion_process_traits::zone_neighbor_range_type zone_neighbor_range_type;
+	typedef fusion_process_traits::progress_monitor_type progress_monitor_type;
 	typedef fusion_process_traits::zone_info_policy_type zone_info_policy_type;
 	typedef fusion_process_traits::fusion_map_range_type fusion_map_range_type;
+	typedef fusion_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
 
 	BOOST_MOVABLE_BUT_NOT_COPYABLE(fusion_process)
 
@@ -63,7 +66,9 @@ class fusion_process {
 
 public:
 	fusion_process();
-	fusion_process(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors);
+	fusion_process(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	fusion_process(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	fusion_process(const aggregation_type &aggregation, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps);
 	~fusion_process();
 
 	fusion_process & operator= (BOOST_RV_REF(fusion_process) other) {
@@ -72,7 +77,12 @@ public:
 	}
 
 	size_t get_fusion_size() const;
+	size_t get_cut_fusion_size(double distance) const;
 	fusion_map_range_type get_fusion_maps(zone_info_policy_type &zones, size_t begin, size_t end, bool compute_zones = false);
+	zone_fusion_step_container_type get_fusion_steps(const zone_info_policy_type &zones) const;
+
+	static void normalize_features(feature_range_type &features);
+	static void normalize_attribute_distances(attribute_distance_range_type &attribute_distances);
 
 	bool is_implemented() const {
 		return impl;
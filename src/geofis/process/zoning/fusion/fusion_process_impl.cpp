@@ -37,28 +37,77 @@
  * knowledge of the CeCILL license and that you accept its terms.
  */
 #include <geofis/process/zoning/fusion/fusion_process_impl.hpp>
-#include <boost/assign/list_inserter.hpp>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
 #include <util/range/ref_range.hpp>
+#include <util/thread/thread_pool.hpp>
 
 using namespace util;
 using namespace boost;
-using namespace boost::assign;
 using namespace boost::adaptors;
 
 namespace geofis {
 
+/**
+ * The reciprocal fusion keeps the fusion hierarchy of the exact fusion with the maximum zone distance only.
+ */
+template <class FusionStrategy, class ZoneDistance> static FusionStrategy get_fusion_strategy(const FusionStrategy &fusion_strategy, const ZoneDistance &zone_distance) {
+	if(boost::get<reciprocal_fusion>(&fusion_strategy) && !boost::get<util::maximum<double> >(&zone_distance))
+		return exact_fusion();
+	return fusion_strategy;
+}
+
 fusion_process_impl::fusion_process_impl() {}
 
-fusion_process_impl::fusion_process_impl(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors) : aggregation(aggregation) {
+fusion_process_impl::fusion_process_impl(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) : aggregation(aggregation), fusion_strategy(get_fusion_strategy(fusion_strategy, zone_distance)) {
+	normalize_features(features);
+	compute_zone_fusions(zone_distance, multidimensional_distance, attribute_distances, zone_neighbors, boost::empty(features) ? 0 : boost::size(features) - 1, progress);
+}
+
+/**
+ * The features of the zone neighbors must be already normalized, they are only read so that several fusions of the
+ * same zone neighbors can be computed concurrently.
+ */
+fusion_process_impl::fusion_process_impl(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) : aggregation(aggregation), fusion_strategy(get_fusion_strategy(fusion_strategy, zone_distance)) {
+	compute_zone_fusions(zone_distance, multidimensional_distance, attribute_distances, zone_neighbors, 0, progress);
+}
+
+fusion_process_impl::fusion_process_impl(const aggregation_type &aggregation, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps) : aggregation(aggregation) {
 	normalize_attribute_distances(attribute_distances);
-	feature_distance = make_feature_distance<feature_distance_type>(multidimensional_distance, attribute_distances);
+	normalize_features(features);
+	restore_zone_fusions(zones, zone_fusion_steps);
+}
+
+fusion_process_impl::~fusion_process_impl() {}
+
+void fusion_process_impl::normalize_features(feature_range_type &features) {
 	feature_normalization_type feature_normalization(feature_normalization_type::initialize(features));
 	feature_normalization.normalize(features);
-	initialize_zone_pairs_with_neighbors(zone_distance, zone_neighbors);
-	aggregate_zone_pairs(zone_pair_updater_type(feature_distance));
 }
 
-fusion_process_impl::~fusion_process_impl() {}
+/**
+ * The reciprocal fusion searches the nearest zone pairs of every round on the threads of a pool created once for the
+ * fusion, the threads waiting for the next round.
+ */
+void fusion_process_impl::compute_zone_fusions(const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type &attribute_distances, zone_neighbor_range_type &zone_neighbors, size_t fusion_size, progress_monitor_type &progress) {
+	normalize_attribute_distances(attribute_distances);
+	feature_distance = make_feature_distance<feature_distance_type>(multidimensional_distance, attribute_distances);
+	initialize_zone_pairs_with_neighbors(zone_distance, zone_neighbors);
+	progress.start("fusion", fusion_size);
+	reciprocal_fusion *reciprocal = boost::get<reciprocal_fusion>(&fusion_strategy.variant_aggregation);
+	thread_pool fusion_thread_pool(reciprocal && reciprocal->thread_count ? reciprocal->thread_count : thread_pool::default_thread_count());
+	if(reciprocal)
+		reciprocal->fusion_thread_pool = &fusion_thread_pool;
+	aggregate_zone_pairs(zone_pair_updater_type(feature_distance), progress);
+	if(reciprocal) {
+		reciprocal->fusion_thread_pool = nullptr;
+		sort_zone_fusions();
+	}
+	initialize_fusion_heights();
+	progress.finish();
+}
 
 struct normalize_attribute_distance {
 
@@ -81,7 +130,7 @@ void fusion_process_impl::normalize_attribute_distances(attribute_distance_range
 }
 
 void fusion_process_impl::initialize_zone_pairs_with_neighbors(const zone_distance_type &zone_distance, zone_neighbor_range_type &zone_neighbors) {
-	push_back(zone_pairs).range(transform(zone_neighbors, neighbor_to_zone_pair_type(zone_distance, feature_distance)));
+	zone_pairs.insert(transform(zone_neighbors, neighbor_to_zone_pair_type(zone_distance, feature_distance)));
 }
 
 /**
@@ -91,7 +140,7 @@ title aggregate_zone_pairs activity diagram\n
 
 start
 
-floating note left: In this diagram **zone_pair** and **zone_pair_to_merge** are an iterator type.
+floating note left: In this diagram **zone_pair** and **zone_pair_to_merge** are a handle type.
 
 :transform **zone_neighbors** to **zone_pairs**;
 :sort **zone_pairs** by id comparator;
@@ -100,8 +149,8 @@ note right
 	CGAL delaunay triangulation is not reproducible
 	so **zone_neighbors** are not ordered
 
-	**zone_pairs** is std::list<zone_pair>
-	this guarantees iterator validity on remove operation
+	**zone_pairs** is zone_pair_slab<zone_pair>
+	this guarantees handle validity on remove operation
 end note
 
 while(**zone_pairs** empty ?) is (false)
@@ -112,8 +161,8 @@ while(**zone_pairs** empty ?) is (false)
 		**zone_pairs** are ordered by merging order and
 		**zone_pairs_to_merge** have same merging order
 
-		**zone_pairs_to_merge** is std::list<**zone_pair**>
-		this guarantees iterator validity on remove operation
+		**zone_pairs_to_merge** is std::vector<**zone_pair**>
+		reused from one iteration to the next
 	end note
 
 	:**zone_pair_to_merge** first element of **zone_pairs_to_merge**
@@ -162,10 +211,12 @@ struct zone_pair_size_comparator {
 	}
 };
 
-void fusion_process_impl::aggregate_zone_pairs(const zone_pair_updater_type &zone_pair_updater) {
-    zone_pairs.sort(zone_pair_id_comparator());
+void fusion_process_impl::aggregate_zone_pairs(zone_pair_updater_type zone_pair_updater, progress_monitor_type &progress) {
+    zone_pairs.stable_sort(zone_pair_id_comparator());
+	zone_pair_handle_container_type zone_pairs_to_merge;
+	coarsen_zone_pairs(zone_pair_updater, zone_pairs_to_merge, progress);
 	while(!zone_pairs.empty()) {
-		zone_pair_iterator_container_type zone_pairs_to_merge;
+		zone_pairs_to_merge.clear();
 		aggregation(zone_pairs, std::back_inserter(zone_pairs_to_merge));
 		// try to sorting zone_pairs_to_merge according a comparison function.
 		// not retained: difficult to compare resulting maps.
@@ -175,12 +226,59 @@ void fusion_process_impl::aggregate_zone_pairs(const zone_pair_updater_type &zon
 			//for_each(zone_pairs_to_merge, print_zone_pair_size());
 		//}
 		aggregate_zone_pair(zone_pairs_to_merge.front(), zone_pair_updater, zone_pairs_to_merge);
+		progress.step();
+	}
+}
+
+/**
+ * Merges the zone pairs selected by the fusion strategy round after round, the zone pairs of a round being merged in
+ * their selection order. A merge only updates the zone pairs of the merged zones. The coarse zone pairs are then
+ * sorted by id comparator, so the exact fusion of the coarse zones does not depend on the coarsening order.
+ */
+void fusion_process_impl::coarsen_zone_pairs(zone_pair_updater_type &zone_pair_updater, zone_pair_handle_container_type &zone_pairs_to_merge, progress_monitor_type &progress) {
+	zone_pair_handle_container_type zone_pairs_to_coarsen;
+	bool coarsened = false;
+	for(;;) {
+		zone_pairs_to_coarsen.clear();
+		fusion_strategy(zone_pairs, std::back_inserter(zone_pairs_to_coarsen));
+		if(zone_pairs_to_coarsen.empty())
+			break;
+		for(zone_pair_handle_type zone_pair_to_coarsen : zone_pairs_to_coarsen) {
+			zone_pairs_to_merge.clear();
+			aggregate_zone_pair(zone_pair_to_coarsen, zone_pair_updater, zone_pairs_to_merge);
+			progress.step();
+		}
+		coarsened = true;
 	}
+	if(coarsened)
+		zone_pairs.stable_sort(zone_pair_id_comparator());
 }
 
-void fusion_process_impl::aggregate_zone_pair(zone_pair_iterator_type zone_pair_to_merge, const zone_pair_updater_type &zone_pair_updater, zone_pair_iterator_container_type &zone_pairs_to_merge) {
-	zone_fusions.push_back(zone_fusion_type(*zone_pair_to_merge));
-	zone_pairs_to_merge.remove(zone_pair_to_merge);
+/**
+ * Sorts the zone fusions by distance with a stable sort, a fusion zone being still created before its fusion as the
+ * distance of its fusion is not less.
+ */
+void fusion_process_impl::sort_zone_fusions() {
+	std::vector<size_t> zone_fusion_order(zone_fusions.size());
+	std::iota(zone_fusion_order.begin(), zone_fusion_order.end(), size_t(0));
+	std::stable_sort(zone_fusion_order.begin(), zone_fusion_order.end(), [this](size_t lhs, size_t rhs) { return zone_fusions[lhs].get_distance() < zone_fusions[rhs].get_distance(); });
+	std::unordered_map<const zone_type *, zone_type *> sorted_zones;
+	auto get_sorted_zone = [&sorted_zones](zone_type &zone) -> zone_type & {
+		auto sorted_zone = sorted_zones.find(&zone);
+		return sorted_zone == sorted_zones.end() ? zone : *sorted_zone->second;
+	};
+	zone_fusion_container_type sorted_zone_fusions;
+	for(size_t zone_fusion_index : zone_fusion_order) {
+		zone_fusion_type &zone_fusion = zone_fusions[zone_fusion_index];
+		sorted_zone_fusions.push_back(zone_fusion_type(get_sorted_zone(zone_fusion.get_zone1()), get_sorted_zone(zone_fusion.get_zone2()), zone_fusion.get_distance()));
+		sorted_zones[&zone_fusion.get_fusion()] = &sorted_zone_fusions.back().get_fusion();
+	}
+	zone_fusions.swap(sorted_zone_fusions);
+}
+
+void fusion_process_impl::aggregate_zone_pair(zone_pair_handle_type zone_pair_to_merge, zone_pair_updater_type &zone_pair_updater, zone_pair_handle_container_type &zone_pairs_to_merge) {
+	zone_fusions.push_back(zone_fusion_type(zone_pairs[zone_pair_to_merge]));
+	zone_pairs_to_merge.erase(std::remove(zone_pairs_to_merge.begin(), zone_pairs_to_merge.end(), zone_pair_to_merge), zone_pairs_to_merge.end());
 	zone_pairs.erase(zone_pair_to_merge);
 	zone_pair_updater.update_zone_pairs(zone_pairs, zone_fusions.back(), zone_pairs_to_merge);
 }
@@ -189,6 +287,56 @@ size_t fusion_process_impl::get_fusion_size() const {
 	return zone_fusions.size();
 }
 
+/**
+ * Replays the fusion steps without computing any distance, the fusion zone of each step is appended to the indexed
+ * zones as the fusion goes along.
+ */
+void fusion_process_impl::restore_zone_fusions(zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps) {
+	std::vector<zone_type *> indexed_zones;
+	indexed_zones.reserve(zones.size() + zone_fusion_steps.size());
+	for(zone_type &zone : zones)
+		indexed_zones.push_back(&zone);
+	for(const zone_fusion_step &zone_fusion_step : zone_fusion_steps) {
+		UTIL_REQUIRE(zone_fusion_step.zone1 < indexed_zones.size() && zone_fusion_step.zone2 < indexed_zones.size());
+		zone_fusions.push_back(zone_fusion_type(*indexed_zones[zone_fusion_step.zone1], *indexed_zones[zone_fusion_step.zone2], zone_fusion_step.distance));
+		indexed_zones.push_back(&zone_fusions.back().get_fusion());
+	}
+	initialize_fusion_heights();
+}
+
+/**
+ * The height of a fusion step is the greatest distance of the fusions up to the step, the heights are increasing even
+ * if the fusion distances are not, as with the multilevel fusion.
+ */
+void fusion_process_impl::initialize_fusion_heights() {
+	fusion_heights.clear();
+	fusion_heights.reserve(zone_fusions.size());
+	for(const zone_fusion_type &zone_fusion : zone_fusions)
+		fusion_heights.push_back(fusion_heights.empty() ? zone_fusion.get_distance() : std::max(fusion_heights.back(), zone_fusion.get_distance()));
+}
+
+/**
+ * Returns the number of the first fusion steps whose distances do not exceed the distance, by a binary search of the
+ * fusion heights.
+ */
+size_t fusion_process_impl::get_cut_fusion_size(double distance) const {
+	return std::upper_bound(fusion_heights.begin(), fusion_heights.end(), distance) - fusion_heights.begin();
+}
+
+fusion_process_impl::zone_fusion_step_container_type fusion_process_impl::get_fusion_steps(const zone_info_policy_type &zones) const {
+	std::unordered_map<const zone_type *, size_t> zone_indices;
+	size_t zone_index = 0;
+	for(const zone_type &zone : zones)
+		zone_indices[&zone] = zone_index++;
+	zone_fusion_step_container_type zone_fusion_steps;
+	zone_fusion_steps.reserve(zone_fusions.size());
+	for(const zone_fusion_type &zone_fusion : zone_fusions) {
+		zone_fusion_steps.push_back(zone_fusion_step(zone_indices.at(&zone_fusion.get_zone1()), zone_indices.at(&zone_fusion.get_zone2()), zone_fusion.get_distance()));
+		zone_indices[&zone_fusion.get_fusion()] = zone_index++;
+	}
+	return zone_fusion_steps;
+}
+
 fusion_process_impl::fusion_map_range_type fusion_process_impl::get_fusion_maps(zone_info_policy_type &zones, size_t begin, size_t end, bool compute_zones) {
 	return make_fusion_map_range(zone_fusions, begin, end, make_ref_range(zones), compute_zones);
 }
@@ -39,10 +39,11 @@
 #ifndef H941EF80A_E62F_4855_B5E5_651F5F416D3A
 #define H941EF80A_E62F_4855_B5E5_651F5F416D3A
 
-#include <list>
+#include <vector>
 #include <geofis/process/zoning/fusion/fusion_process_traits.hpp>
 #include <geofis/algorithm/feature/feature_normalization.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair.hpp>
+#include <geofis/algorithm/zoning/pair/zone_pair_slab.hpp>
 #include <geofis/algorithm/zoning/pair/zone_pair_distance.hpp>
 #include <geofis/algorithm/zoning/fusion/aggregation/aggregation_adaptor.hpp>
 #include <geofis/algorithm/zoning/fusion/neighbor_to_zone_pair.hpp>
@@ -54,13 +55,16 @@ namespace geofis {
 class fusion_process_impl {
 
 	typedef fusion_process_traits::aggregation_type aggregation_type;
+	typedef fusion_process_traits::fusion_strategy_type fusion_strategy_type;
 	typedef fusion_process_traits::zone_distance_type zone_distance_type;
 	typedef fusion_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef fusion_process_traits::attribute_distance_range_type attribute_distance_range_type;
 	typedef fusion_process_traits::feature_range_type feature_range_type;
 	typedef fusion_process_traits::zone_neighbor_range_type zone_neighbor_range_type;
+	typedef fusion_process_traits::progress_monitor_type progress_monitor_type;
 
 	typedef aggregation_adaptor<aggregation_type> aggregation_adaptor_type;
+	typedef aggregation_adaptor<fusion_strategy_type> fusion_strategy_adaptor_type;
 
 	typedef fusion_process_traits::feature_distance_type feature_distance_type;
 
@@ -70,38 +74,52 @@ class fusion_process_impl {
 	typedef zone_pair_distance<zone_distance_type> zone_pair_distance_type;
 	typedef fusion_process_traits::zone_type zone_type;
 	typedef zone_pair<zone_type, zone_pair_distance_type> zone_pair_type;
-	typedef std::list<zone_pair_type> zone_pair_container_type;
-	typedef typename boost::range_iterator<zone_pair_container_type>::type zone_pair_iterator_type;
-	typedef std::list<zone_pair_iterator_type> zone_pair_iterator_container_type;
+	typedef zone_pair_slab<zone_pair_type> zone_pair_container_type;
+	typedef zone_pair_container_type::handle_type zone_pair_handle_type;
+	typedef zone_pair_container_type::handle_container_type zone_pair_handle_container_type;
 	typedef neighbor_to_zone_pair<zone_type, zone_distance_type, feature_distance_type> neighbor_to_zone_pair_type;
 
 	typedef fusion_process_traits::zone_fusion_type zone_fusion_type;
 	typedef fusion_process_traits::zone_fusion_container_type zone_fusion_container_type;
+	typedef fusion_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
 
 	typedef zone_pair_distance_updater<feature_distance_type> zone_pair_distance_updater_type;
-	typedef zone_pair_updater<zone_pair_distance_updater_type> zone_pair_updater_type;
+	typedef zone_pair_updater<zone_pair_distance_updater_type, zone_pair_type> zone_pair_updater_type;
 
 	typedef fusion_process_traits::zone_info_policy_type zone_info_policy_type;
 	typedef fusion_process_traits::fusion_map_range_type fusion_map_range_type;
 
 	aggregation_adaptor_type aggregation;
+	fusion_strategy_adaptor_type fusion_strategy;
 	feature_distance_type feature_distance;
 	zone_pair_container_type zone_pairs;
 	zone_fusion_container_type zone_fusions;
+	std::vector<double> fusion_heights;
 
 public:
 	fusion_process_impl();
-	fusion_process_impl(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors);
+	fusion_process_impl(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	fusion_process_impl(const aggregation_type &aggregation, const fusion_strategy_type &fusion_strategy, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	fusion_process_impl(const aggregation_type &aggregation, attribute_distance_range_type attribute_distances, feature_range_type &features, zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps);
 	~fusion_process_impl();
 
 	size_t get_fusion_size() const;
+	size_t get_cut_fusion_size(double distance) const;
 	fusion_map_range_type get_fusion_maps(zone_info_policy_type &zones, size_t begin, size_t end, bool compute_zones = false);
+	zone_fusion_step_container_type get_fusion_steps(const zone_info_policy_type &zones) const;
+
+	static void normalize_features(feature_range_type &features);
+	static void normalize_attribute_distances(attribute_distance_range_type &attribute_distances);
 
 private:
+	void compute_zone_fusions(const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type &attribute_distances, zone_neighbor_range_type &zone_neighbors, size_t fusion_size, progress_monitor_type &progress);
 	void initialize_zone_pairs_with_neighbors(const zone_distance_type &zone_distance, zone_neighbor_range_type &zone_neighbors);
-	void aggregate_zone_pairs(const zone_pair_updater_type &zone_pair_updater);
-	void aggregate_zone_pair(zone_pair_iterator_type zone_pair_to_merge, const zone_pair_updater_type &zone_pair_updater, zone_pair_iterator_container_type &zone_pairs_to_merge);
-	void normalize_attribute_distances(attribute_distance_range_type &attribute_distances);
+	void aggregate_zone_pairs(zone_pair_updater_type zone_pair_updater, progress_monitor_type &progress);
+	void sort_zone_fusions();
+	void coarsen_zone_pairs(zone_pair_updater_type &zone_pair_updater, zone_pair_handle_container_type &zone_pairs_to_merge, progress_monitor_type &progress);
+	void aggregate_zone_pair(zone_pair_handle_type zone_pair_to_merge, zone_pair_updater_type &zone_pair_updater, zone_pair_handle_container_type &zone_pairs_to_merge);
+	void restore_zone_fusions(zone_info_policy_type &zones, const zone_fusion_step_container_type &zone_fusion_steps);
+	void initialize_fusion_heights();
 };
 
 } // namespace geofis
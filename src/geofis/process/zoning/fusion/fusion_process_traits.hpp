@@ -46,6 +46,7 @@ namespace geofis {
 struct fusion_process_traits {
 
 	typedef zoning_process_traits::aggregation_type aggregation_type;
+	typedef zoning_process_traits::fusion_strategy_type fusion_strategy_type;
 	typedef zoning_process_traits::zone_distance_type zone_distance_type;
 	typedef zoning_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef zoning_process_traits::feature_distance_type feature_distance_type;
@@ -62,9 +63,12 @@ struct fusion_process_traits {
 
 	typedef zoning_process_traits::zone_fusion_type zone_fusion_type;
 	typedef zoning_process_traits::zone_fusion_container_type zone_fusion_container_type;
+	typedef zoning_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
 
 	typedef zoning_process_traits::zone_info_policy_type zone_info_policy_type;
 	typedef zoning_process_traits::fusion_map_range_type fusion_map_range_type;
+
+	typedef zoning_process_traits::progress_monitor_type progress_monitor_type;
 };
 
 } // namespace geofis
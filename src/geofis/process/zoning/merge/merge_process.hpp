@@ -48,6 +48,7 @@ class merge_process_impl;
 
 class merge_process {
 
+	typedef merge_process_traits::fusion_map_type fusion_map_type;
 	typedef merge_process_traits::fusion_map_range_type fusion_map_range_type;
 	typedef merge_process_traits::merge_type merge_type;
 	typedef merge_process_traits::merge_map_type merge_map_type;
@@ -56,6 +57,7 @@ class merge_process {
 	typedef merge_process_traits::zone_distance_type zone_distance_type;
 	typedef merge_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef merge_process_traits::const_attribute_distance_range_type const_attribute_distance_range_type;
+	typedef merge_process_traits::progress_monitor_type progress_monitor_type;
 
 	BOOST_MOVABLE_BUT_NOT_COPYABLE(merge_process)
 
@@ -76,8 +78,9 @@ public:
 	}
 
 	size_t get_merge_size() const;
+	const fusion_map_type &get_fusion_map(size_t map_index) const;
 
-	merge_map_type get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances) const;
+	merge_map_type get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances, progress_monitor_type &progress) const;
 
 private:
 	merge_process &move_assign(merge_process &other);
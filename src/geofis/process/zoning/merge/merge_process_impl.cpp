@@ -67,7 +67,11 @@ size_t merge_process_impl::get_merge_size() const {
 	return fusion_maps.size();
 }
 
-merge_process_impl::merge_map_type merge_process_impl::get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances) const {
+const merge_process_impl::fusion_map_type &merge_process_impl::get_fusion_map(size_t map_index) const {
+	return fusion_maps.at(map_index);
+}
+
+merge_process_impl::merge_map_type merge_process_impl::get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances, progress_monitor_type &progress) const {
 
 	typedef merge_process_traits::zone_type zone_type;
 	typedef merging<zone_type> merging_type;
@@ -81,7 +85,9 @@ merge_process_impl::merge_map_type merge_process_impl::get_merge_map(size_t map_
 	neighboring_type neighboring(neighborhood);
 	zone_distance_adapter_type zone_distance_adapter(zone_distance, multidimensional_distance, attribute_distances);
 	aggregation_adaptor_type aggregatrion_adaptor(aggregation);
-	merging.compute_merge_zones(neighboring, zone_distance_adapter, aggregatrion_adaptor);
+	progress.start("merge", merging.get_merged_zones_size());
+	merging.compute_merge_zones(neighboring, zone_distance_adapter, aggregatrion_adaptor, progress);
+	progress.finish();
 	return merge_map_type(merging.get_mergeable_zones());
 }
 
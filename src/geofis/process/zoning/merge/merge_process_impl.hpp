@@ -57,6 +57,7 @@ class merge_process_impl {
 	typedef merge_process_traits::zone_distance_type zone_distance_type;
 	typedef merge_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef merge_process_traits::const_attribute_distance_range_type const_attribute_distance_range_type;
+	typedef merge_process_traits::progress_monitor_type progress_monitor_type;
 
 	merge_predicate_type merge_predicate;
 	fusion_map_container_type fusion_maps;
@@ -66,8 +67,9 @@ public:
 	~merge_process_impl();
 
 	size_t get_merge_size() const;
+	const fusion_map_type &get_fusion_map(size_t map_index) const;
 
-	merge_map_type get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances) const;
+	merge_map_type get_merge_map(size_t map_index, const neighborhood_type &neighborhood, const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const const_attribute_distance_range_type &attribute_distances, progress_monitor_type &progress) const;
 };
 
 } // namespace geofis
@@ -56,6 +56,7 @@ struct merge_process_traits {
 	typedef zoning_process_traits::feature_distance_type feature_distance_type;
 	typedef zoning_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef zoning_process_traits::const_attribute_distance_range_type const_attribute_distance_range_type;
+	typedef zoning_process_traits::progress_monitor_type progress_monitor_type;
 };
 
 } // namespace geofis
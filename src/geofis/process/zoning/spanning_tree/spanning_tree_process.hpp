@@ -0,0 +1,91 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef HD8B825EF_F4ED_4EA5_82FC_EA27F3C3ACE5
+#define HD8B825EF_F4ED_4EA5_82FC_EA27F3C3ACE5
+
+#include <boost/move/unique_ptr.hpp>
+#include <geofis/process/zoning/spanning_tree/spanning_tree_process_traits.hpp>
+
+namespace geofis {
+
+class spanning_tree_process_impl;
+
+/**
+ * Computes a fusion of the voronoi zones by partitioning the minimum spanning tree of their neighbors, see
+ * spanning_tree_partition. The fusion steps are restored by a fusion_process, so the fusion maps and the merge are
+ * those of the agglomerative fusion.
+ */
+class spanning_tree_process {
+
+	typedef spanning_tree_process_traits::multidimensional_distance_type multidimensional_distance_type;
+	typedef spanning_tree_process_traits::attribute_distance_range_type attribute_distance_range_type;
+	typedef spanning_tree_process_traits::feature_range_type feature_range_type;
+	typedef spanning_tree_process_traits::zone_neighbor_range_type zone_neighbor_range_type;
+	typedef spanning_tree_process_traits::zone_info_policy_type zone_info_policy_type;
+	typedef spanning_tree_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
+	typedef spanning_tree_process_traits::progress_monitor_type progress_monitor_type;
+
+	BOOST_MOVABLE_BUT_NOT_COPYABLE(spanning_tree_process)
+
+	boost::movelib::unique_ptr<spanning_tree_process_impl> impl;
+
+public:
+	spanning_tree_process();
+	spanning_tree_process(const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, const zone_info_policy_type &zones, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	spanning_tree_process(const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, const zone_info_policy_type &zones, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress);
+	~spanning_tree_process();
+
+	spanning_tree_process & operator= (BOOST_RV_REF(spanning_tree_process) other) {
+		// see bug https://gcc.gnu.org/bugzilla/show_bug.cgi?id=53725
+		return move_assign(other);
+	}
+
+	const zone_fusion_step_container_type &get_fusion_steps() const;
+
+	bool is_implemented() const {
+		return impl;
+	}
+
+private:
+	spanning_tree_process &move_assign(spanning_tree_process &other);
+};
+
+} // namespace geofis
+
+#endif // HD8B825EF_F4ED_4EA5_82FC_EA27F3C3ACE5 
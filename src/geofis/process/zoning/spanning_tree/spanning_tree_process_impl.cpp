@@ -0,0 +1,118 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#include <geofis/process/zoning/spanning_tree/spanning_tree_process_impl.hpp>
+#include <geofis/process/zoning/fusion/fusion_process.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <util/functional/binary_reference_adaptor.hpp>
+
+using namespace util;
+using namespace boost;
+
+namespace geofis {
+
+spanning_tree_process_impl::spanning_tree_process_impl(const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, feature_range_type &features, const zone_info_policy_type &zones, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) {
+	fusion_process::normalize_features(features);
+	compute_zone_fusion_steps(multidimensional_distance, attribute_distances, zones, zone_neighbors, progress);
+}
+
+/**
+ * The features of the zones must be already normalized, they are only read.
+ */
+spanning_tree_process_impl::spanning_tree_process_impl(const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type attribute_distances, const zone_info_policy_type &zones, zone_neighbor_range_type zone_neighbors, progress_monitor_type &progress) {
+	compute_zone_fusion_steps(multidimensional_distance, attribute_distances, zones, zone_neighbors, progress);
+}
+
+spanning_tree_process_impl::~spanning_tree_process_impl() {}
+
+void spanning_tree_process_impl::compute_zone_fusion_steps(const multidimensional_distance_type &multidimensional_distance, attribute_distance_range_type &attribute_distances, const zone_info_policy_type &zones, zone_neighbor_range_type &zone_neighbors, progress_monitor_type &progress) {
+	fusion_process::normalize_attribute_distances(attribute_distances);
+	feature_distance_type feature_distance = make_feature_distance<feature_distance_type>(multidimensional_distance, attribute_distances);
+	size_t attribute_size = 0;
+	std::vector<double> attributes = get_vertex_attributes(attribute_distances, zones, attribute_size);
+	edge_container_type edges = get_edges(feature_distance, zones, zone_neighbors);
+	progress.start("fusion", zones.size() ? zones.size() - 1 : 0);
+	zone_fusion_steps = spanning_tree_partition(zones.size(), attribute_size, attributes)(edges, progress);
+	progress.finish();
+}
+
+/**
+ * The heterogeneity of a zone is computed with the normalized attributes of its features, the attributes left out by
+ * the none distance are not used.
+ */
+std::vector<double> spanning_tree_process_impl::get_vertex_attributes(const attribute_distance_range_type &attribute_distances, const zone_info_policy_type &zones, size_t &attribute_size) const {
+	std::vector<size_t> attribute_indices;
+	for(size_t index = 0; index < size_t(boost::size(attribute_distances)); ++index)
+		if(!boost::get<none_distance<double> >(&attribute_distances[index]))
+			attribute_indices.push_back(index);
+	attribute_size = attribute_indices.size();
+	std::vector<double> attributes;
+	attributes.reserve(zones.size() * attribute_size);
+	for(const zone_type &zone : zones)
+		for(size_t attribute_index : attribute_indices)
+			attributes.push_back(zone.get_feature(0).get_normalized_attribute_range()[attribute_index]);
+	return attributes;
+}
+
+/**
+ * The edges are sorted by vertices, as the zone neighbors computed from the delaunay triangulation are not
+ * reproducible.
+ */
+spanning_tree_process_impl::edge_container_type spanning_tree_process_impl::get_edges(const feature_distance_type &feature_distance, const zone_info_policy_type &zones, zone_neighbor_range_type &zone_neighbors) const {
+	std::unordered_map<const zone_type *, size_t> zone_indices;
+	size_t zone_index = 0;
+	for(const zone_type &zone : zones)
+		zone_indices[&zone] = zone_index++;
+	binary_reference_adaptor<const feature_distance_type> distance(feature_distance);
+	edge_container_type edges;
+	edges.reserve(boost::size(zone_neighbors));
+	for(const auto &zone_neighbor : zone_neighbors) {
+		size_t vertex1 = zone_indices.at(&zone_neighbor.get_zone1());
+		size_t vertex2 = zone_indices.at(&zone_neighbor.get_zone2());
+		edges.push_back(spanning_tree_edge(std::min(vertex1, vertex2), std::max(vertex1, vertex2), distance(zone_neighbor.get_zone1().get_feature(0), zone_neighbor.get_zone2().get_feature(0))));
+	}
+	std::sort(edges.begin(), edges.end(), [](const spanning_tree_edge &lhs, const spanning_tree_edge &rhs) { return lhs.vertex1 == rhs.vertex1 ? lhs.vertex2 < rhs.vertex2 : lhs.vertex1 < rhs.vertex1; });
+	return edges;
+}
+
+const spanning_tree_process_impl::zone_fusion_step_container_type &spanning_tree_process_impl::get_fusion_steps() const {
+	return zone_fusion_steps;
+}
+
+} // namespace geofis
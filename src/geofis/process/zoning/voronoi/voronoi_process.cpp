@@ -45,7 +45,11 @@ namespace geofis {
 
 voronoi_process::voronoi_process() : impl(nullptr) {}
 
-voronoi_process::voronoi_process(const feature_range_type &features, const polygon_type &border) : impl(new voronoi_process_impl(features, border)) {}
+voronoi_process::voronoi_process(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, progress_monitor_type &progress) : impl(new voronoi_process_impl(features, border, construction, progress)) {}
+
+voronoi_process::voronoi_process(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, size_t tile_count, progress_monitor_type &progress) : impl(new voronoi_process_impl(features, border, construction, tile_count, progress)) {}
+
+voronoi_process::voronoi_process(const feature_range_type &features, const polygon_container_type &geometries) : impl(new voronoi_process_impl(features, geometries)) {}
 
 voronoi_process::~voronoi_process() {}
 
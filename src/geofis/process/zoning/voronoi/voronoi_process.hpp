@@ -52,15 +52,20 @@ class voronoi_process {
 
 	typedef voronoi_process_traits::feature_range_type feature_range_type;
 	typedef voronoi_process_traits::polygon_type polygon_type;
+	typedef voronoi_process_traits::polygon_container_type polygon_container_type;
 	typedef voronoi_process_traits::zone_info_policy_type zone_info_policy_type;
 	typedef voronoi_process_traits::voronoi_map_type voronoi_map_type;
 	typedef voronoi_process_traits::finite_edge_range_type finite_edge_range_type;
+	typedef voronoi_process_traits::voronoi_construction_type voronoi_construction_type;
+	typedef voronoi_process_traits::progress_monitor_type progress_monitor_type;
 
 	boost::movelib::unique_ptr<voronoi_process_impl> impl;
 
 public:
 	voronoi_process();
-	voronoi_process(const feature_range_type &features, const polygon_type &border);
+	voronoi_process(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, progress_monitor_type &progress);
+	voronoi_process(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, size_t tile_count, progress_monitor_type &progress);
+	voronoi_process(const feature_range_type &features, const polygon_container_type &geometries);
 	~voronoi_process();
 
 	voronoi_process & operator= (BOOST_RV_REF(voronoi_process) other) {
@@ -37,11 +37,28 @@
  * knowledge of the CeCILL license and that you accept its terms.
  */
 #include <geofis/process/zoning/voronoi/voronoi_process_impl.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_tiling.hpp>
 
 namespace geofis {
 
-voronoi_process_impl::voronoi_process_impl(const feature_range_type &features, const polygon_type &border) {
-	voronoi_map.initialize(features, border, zones);
+voronoi_process_impl::voronoi_process_impl(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, progress_monitor_type &progress) {
+	progress.start("voronoi", boost::size(features));
+	voronoi_map.initialize(features, border, zones, construction, progress);
+	progress.finish();
+}
+
+/**
+ * Computes the voronoi geometries by tiles on the available threads, the voronoi map is then restored from them.
+ */
+voronoi_process_impl::voronoi_process_impl(const feature_range_type &features, const polygon_type &border, const voronoi_construction_type &construction, size_t tile_count, progress_monitor_type &progress) {
+	progress.start("voronoi", boost::size(features));
+	polygon_container_type geometries = compute_tiled_voronoi_geometries<kernel_type>(features, border, construction, tile_count, util::thread_pool::default_thread_count(), progress);
+	voronoi_map.restore(features, geometries, zones);
+	progress.finish();
+}
+
+voronoi_process_impl::voronoi_process_impl(const feature_range_type &features, const polygon_container_type &geometries) {
+	voronoi_map.restore(features, geometries, zones);
 }
 
 voronoi_process_impl::~voronoi_process_impl() {}
@@ -45,11 +45,15 @@ namespace geofis {
 
 struct voronoi_process_traits {
 
+	typedef zoning_process_traits::kernel_type kernel_type;
 	typedef zoning_process_traits::feature_range_type feature_range_type;
 	typedef zoning_process_traits::polygon_type polygon_type;
+	typedef zoning_process_traits::polygon_container_type polygon_container_type;
 	typedef zoning_process_traits::zone_info_policy_type zone_info_policy_type;
 	typedef zoning_process_traits::voronoi_map_type voronoi_map_type;
 	typedef zoning_process_traits::finite_edge_range_type finite_edge_range_type;
+	typedef zoning_process_traits::voronoi_construction_type voronoi_construction_type;
+	typedef zoning_process_traits::progress_monitor_type progress_monitor_type;
 };
 
 } // namespace geofis
@@ -0,0 +1,310 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef H16ECD86E_064B_44A7_B73B_37069BCE4862
+#define H16ECD86E_064B_44A7_B73B_37069BCE4862
+
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <boost/range.hpp>
+#include <boost/variant/static_visitor.hpp>
+#include <geofis/process/zoning/zoning_process_traits.hpp>
+
+namespace geofis {
+
+constexpr uint32_t make_zoning_checkpoint_tag(char c1, char c2, char c3, char c4) {
+	return uint32_t(uint8_t(c1)) | uint32_t(uint8_t(c2)) << 8 | uint32_t(uint8_t(c3)) << 16 | uint32_t(uint8_t(c4)) << 24;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Binary layout of a zoning checkpoint: a header (magic, version, byte order mark, section count) followed by tagged
+ * sections. Each section is a tag, a reserved word and the payload size, its payload is padded to 8 bytes so that the
+ * arrays it holds stay aligned when the file is memory mapped. The values are written in the native byte order, a
+ * checkpoint written with another byte order is rejected. Unknown sections are skipped, so that sections can be added
+ * without changing the version.
+ */
+struct zoning_checkpoint_format {
+
+	static constexpr char magic[8] = { 'G', 'E', 'O', 'F', 'I', 'S', 'Z', 'C' };
+	static constexpr uint32_t version = 3;
+	static constexpr uint32_t byte_order_mark = 0x01020304;
+	static constexpr size_t alignment = 8;
+
+	static constexpr uint32_t configuration_tag = make_zoning_checkpoint_tag('C', 'O', 'N', 'F');
+	static constexpr uint32_t feature_tag = make_zoning_checkpoint_tag('F', 'E', 'A', 'T');
+	static constexpr uint32_t border_tag = make_zoning_checkpoint_tag('B', 'O', 'R', 'D');
+	static constexpr uint32_t cell_tag = make_zoning_checkpoint_tag('C', 'E', 'L', 'L');
+	static constexpr uint32_t neighbor_tag = make_zoning_checkpoint_tag('N', 'B', 'R', 'S');
+	static constexpr uint32_t fusion_tag = make_zoning_checkpoint_tag('F', 'U', 'S', 'N');
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Thrown when a checkpoint can not be read or does not match the zoning it is loaded into.
+ */
+struct zoning_checkpoint_error : public std::runtime_error {
+
+	zoning_checkpoint_error(const std::string &what) : std::runtime_error("zoning checkpoint: " + what) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the parameter of a zoning strategy, the strategies without parameter return 0. The partition of a fuzzy
+ * attribute distance is not known to the zoning, a zoning with fuzzy attribute distances is not saved.
+ */
+struct zoning_checkpoint_parameter : public boost::static_visitor<double> {
+
+	double operator()(const edge_length_neighborhood &neighborhood) const {
+		return neighborhood.edge_length;
+	}
+
+	double operator()(const util::minkowski_distance<double> &minkowski_distance) const {
+		return minkowski_distance.power;
+	}
+
+	double operator()(const multilevel_fusion &fusion_strategy) const {
+		return fusion_strategy.coarse_zone_size;
+	}
+
+	double operator()(const square_feature_binning &feature_binning) const {
+		return feature_binning.cell_size;
+	}
+
+	double operator()(const hexagonal_feature_binning &feature_binning) const {
+		return feature_binning.cell_size;
+	}
+
+	template <class Strategy> double operator()(const Strategy &) const {
+		return 0;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class zoning_checkpoint_writer {
+
+	typedef std::pair<uint32_t, std::string> section_type;
+
+	std::vector<section_type> sections;
+
+public:
+	void begin_section(uint32_t tag) {
+		sections.push_back(section_type(tag, std::string()));
+	}
+
+	template <class T> void write(const T &value) {
+		static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+		sections.back().second.append(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <class Range> void write_range(const Range &values) {
+		for(const auto &value : values)
+			write(value);
+	}
+
+	/**
+	 * Pads the payload to the alignment, so that the following array is aligned.
+	 */
+	void align() {
+		std::string &payload = sections.back().second;
+		payload.resize((payload.size() + zoning_checkpoint_format::alignment - 1) / zoning_checkpoint_format::alignment * zoning_checkpoint_format::alignment, 0);
+	}
+
+	void write_string(const std::string &value) {
+		sections.back().second.append(value);
+	}
+
+	const std::string &get_payload(uint32_t tag) const {
+		for(const section_type &section : sections)
+			if(section.first == tag)
+				return section.second;
+		throw zoning_checkpoint_error("missing section");
+	}
+
+	void flush(std::ostream &stream) const {
+		stream.write(zoning_checkpoint_format::magic, sizeof(zoning_checkpoint_format::magic));
+		write(stream, zoning_checkpoint_format::version);
+		write(stream, zoning_checkpoint_format::byte_order_mark);
+		write(stream, uint32_t(sections.size()));
+		write(stream, uint32_t(0));
+		for(const section_type &section : sections) {
+			write(stream, section.first);
+			write(stream, uint32_t(0));
+			write(stream, uint64_t(section.second.size()));
+			stream.write(section.second.data(), section.second.size());
+			for(size_t padding = section.second.size(); padding % zoning_checkpoint_format::alignment != 0; ++padding)
+				stream.put(0);
+		}
+		if(!stream)
+			throw zoning_checkpoint_error("write failed");
+	}
+
+private:
+	template <class T> static void write(std::ostream &stream, const T &value) {
+		stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reads the values of a section payload, every read is checked against the payload size.
+ */
+class zoning_checkpoint_section {
+
+	const std::string &payload;
+	size_t offset;
+
+public:
+	zoning_checkpoint_section(const std::string &payload) : payload(payload), offset(0) {}
+
+	template <class T> T read() {
+		static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+		require(sizeof(T));
+		T value;
+		std::memcpy(&value, payload.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return value;
+	}
+
+	template <class T> std::vector<T> read_vector(uint64_t size) {
+		if(size > (payload.size() - offset) / sizeof(T))
+			throw zoning_checkpoint_error("truncated section");
+		std::vector<T> values(size);
+		std::memcpy(values.data(), payload.data() + offset, size * sizeof(T));
+		offset += size * sizeof(T);
+		return values;
+	}
+
+	void align() {
+		uint64_t padding = (zoning_checkpoint_format::alignment - offset % zoning_checkpoint_format::alignment) % zoning_checkpoint_format::alignment;
+		require(padding);
+		offset += padding;
+	}
+
+private:
+	void require(uint64_t size) const {
+		if(size > payload.size() - offset)
+			throw zoning_checkpoint_error("truncated section");
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class zoning_checkpoint_reader {
+
+	std::map<uint32_t, std::string> sections;
+
+public:
+	zoning_checkpoint_reader(std::istream &stream) {
+		char magic[sizeof(zoning_checkpoint_format::magic)];
+		stream.read(magic, sizeof(magic));
+		if(!stream || std::memcmp(magic, zoning_checkpoint_format::magic, sizeof(magic)) != 0)
+			throw zoning_checkpoint_error("not a zoning checkpoint");
+		if(read<uint32_t>(stream) != zoning_checkpoint_format::version)
+			throw zoning_checkpoint_error("unsupported version");
+		if(read<uint32_t>(stream) != zoning_checkpoint_format::byte_order_mark)
+			throw zoning_checkpoint_error("unsupported byte order");
+		uint32_t section_size = read<uint32_t>(stream);
+		read<uint32_t>(stream);
+		for(uint32_t section_index = 0; section_index < section_size; ++section_index) {
+			uint32_t tag = read<uint32_t>(stream);
+			read<uint32_t>(stream);
+			uint64_t payload_size = read<uint64_t>(stream);
+			std::string &payload = sections[tag];
+			read_payload(stream, payload, payload_size);
+			stream.ignore((zoning_checkpoint_format::alignment - payload_size % zoning_checkpoint_format::alignment) % zoning_checkpoint_format::alignment);
+		}
+	}
+
+	bool has_section(uint32_t tag) const {
+		return sections.count(tag) != 0;
+	}
+
+	const std::string &get_payload(uint32_t tag) const {
+		auto section = sections.find(tag);
+		if(section == sections.end())
+			throw zoning_checkpoint_error("missing section");
+		return section->second;
+	}
+
+	zoning_checkpoint_section get_section(uint32_t tag) const {
+		return zoning_checkpoint_section(get_payload(tag));
+	}
+
+private:
+	template <class T> static T read(std::istream &stream) {
+		T value;
+		stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+		if(!stream)
+			throw zoning_checkpoint_error("truncated file");
+		return value;
+	}
+
+	/**
+	 * The payload is read by chunks, so that a corrupted size fails on the end of file instead of allocating it.
+	 */
+	static void read_payload(std::istream &stream, std::string &payload, uint64_t payload_size) {
+		const uint64_t chunk_size = 1 << 20;
+		payload.clear();
+		while(payload.size() < payload_size) {
+			size_t offset = payload.size();
+			size_t size = std::min(chunk_size, payload_size - offset);
+			payload.resize(offset + size);
+			stream.read(&payload[offset], size);
+			if(!stream)
+				throw zoning_checkpoint_error("truncated file");
+		}
+	}
+};
+
+} // namespace geofis
+
+#endif // H16ECD86E_064B_44A7_B73B_37069BCE4862
@@ -45,6 +45,8 @@ namespace geofis {
 
 zoning_process::zoning_process(const feature_container_type &features) : impl(new zoning_process_impl(features)) {}
 
+zoning_process::zoning_process(feature_container_type &&features) : impl(new zoning_process_impl(std::move(features))) {}
+
 zoning_process::~zoning_process() {}
 
 void zoning_process::set_border(const polygon_type &border) {
@@ -55,6 +57,18 @@ zoning_process::polygon_type zoning_process::get_border() const {
 	return impl->get_border();
 }
 
+void zoning_process::set_feature_binning(const feature_binning_type &feature_binning) {
+	impl->set_feature_binning(feature_binning);
+}
+
+void zoning_process::set_voronoi_construction(const voronoi_construction_type &voronoi_construction) {
+	impl->set_voronoi_construction(voronoi_construction);
+}
+
+void zoning_process::set_voronoi_tile_count(size_t voronoi_tile_count) {
+	impl->set_voronoi_tile_count(voronoi_tile_count);
+}
+
 void zoning_process::compute_voronoi_process() {
 	impl->compute_voronoi_process();
 }
@@ -99,6 +113,10 @@ void zoning_process::set_aggregation(const aggregation_type &aggregation) {
 	impl->set_aggregation(aggregation);
 }
 
+void zoning_process::set_fusion_strategy(const fusion_strategy_type &fusion_strategy) {
+	impl->set_fusion_strategy(fusion_strategy);
+}
+
 void zoning_process::set_zone_distance(const zone_distance_type &zone_distance) {
 	impl->set_zone_distance(zone_distance);
 }
@@ -127,6 +145,10 @@ size_t zoning_process::get_fusion_size() const {
 	return impl->get_fusion_size();
 }
 
+size_t zoning_process::get_cut_zone_size(double distance) const {
+	return impl->get_cut_zone_size(distance);
+}
+
 zoning_process::fusion_map_range_type zoning_process::get_fusion_maps(size_t begin, size_t end, bool compute_zones) {
 	return impl->get_fusion_maps(begin, end, compute_zones);
 }
@@ -135,6 +157,26 @@ zoning_process::reverse_fusion_map_range_type zoning_process::get_reverse_fusion
 	return reverse(impl->get_fusion_maps(begin, end, compute_zones));
 }
 
+zoning_process::zone_fusion_step_container_list_type zoning_process::compute_fusion_sweep(const fusion_configuration_container_type &fusion_configurations, size_t thread_count) {
+	return impl->compute_fusion_sweep(fusion_configurations, thread_count);
+}
+
+void zoning_process::restore_fusion_process(const zone_fusion_step_container_type &zone_fusion_steps) {
+	impl->restore_fusion_process(zone_fusion_steps);
+}
+
+zoning_process::zoning_quality_container_type zoning_process::get_fusion_qualities() {
+	return impl->get_fusion_qualities();
+}
+
+std::vector<std::string> zoning_process::get_fusion_leaf_ids() {
+	return impl->get_fusion_leaf_ids();
+}
+
+void zoning_process::get_fusion_dendrogram(int *merges, double *heights, int *order) {
+	impl->get_fusion_dendrogram(merges, heights, order);
+}
+
 size_t zoning_process::get_unique_feature_size() const {
 	return impl->get_unique_feature_size();
 }
@@ -143,6 +185,14 @@ size_t zoning_process::get_bounded_feature_size() const {
 	return impl->get_bounded_feature_size();
 }
 
+size_t zoning_process::get_site_feature_size() const {
+	return impl->get_site_feature_size();
+}
+
+zoning_process::feature_bin_container_type zoning_process::get_feature_bins() const {
+	return impl->get_feature_bins();
+}
+
 void zoning_process::set_merge(const merge_type &merge) {
 	impl->set_merge(merge);
 }
@@ -171,4 +221,48 @@ zoning_process::merge_map_type zoning_process::get_merge_map(size_t map_index) c
 	return impl->get_merge_map(map_index);
 }
 
+zoning_process::merge_map_type zoning_process::get_merge_map(size_t map_index, double tolerance) const {
+	return impl->get_merge_map(map_index, tolerance);
+}
+
+zoning_process::zone_label_container_type zoning_process::get_merge_map_labels(const point_container_type &points, const std::vector<size_t> &map_indices) const {
+	return impl->get_merge_map_labels(points, map_indices);
+}
+
+zoning_process::raster_grid_type zoning_process::get_raster_grid(double cell_size) const {
+	return impl->get_raster_grid(cell_size);
+}
+
+zoning_process::raster_label_container_type zoning_process::get_merge_map_rasters(const raster_grid_type &grid, const std::vector<size_t> &map_indices) const {
+	return impl->get_merge_map_rasters(grid, map_indices);
+}
+
+zoning_process::zoning_quality_container_type zoning_process::get_merge_qualities(const std::vector<size_t> &map_indices) const {
+	return impl->get_merge_qualities(map_indices);
+}
+
+void zoning_process::set_progress(const progress_callback_type &callback, const cancellation_token_type &cancellation_token) {
+	impl->set_progress(callback, cancellation_token);
+}
+
+void zoning_process::set_stage_cache_capacity(size_t capacity) {
+	impl->set_stage_cache_capacity(capacity);
+}
+
+void zoning_process::set_zone_geometry_cache_budget(size_t budget) {
+	impl->set_zone_geometry_cache_budget(budget);
+}
+
+const zoning_process::zone_geometry_cache_type &zoning_process::get_zone_geometry_cache() const {
+	return impl->get_zone_geometry_cache();
+}
+
+void zoning_process::save(std::ostream &stream, bool save_geometries) {
+	impl->save(stream, save_geometries);
+}
+
+void zoning_process::load(std::istream &stream) {
+	impl->load(stream);
+}
+
 } // namespace geofis
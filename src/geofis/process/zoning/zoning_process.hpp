@@ -39,6 +39,7 @@
 #ifndef HE6CC908B_401E_49A1_B93F_4A00C292ED76
 #define HE6CC908B_401E_49A1_B93F_4A00C292ED76
 
+#include <iosfwd>
 #include <boost/move/unique_ptr.hpp>
 #include <geofis/process/zoning/zoning_process_traits.hpp>
 
@@ -50,27 +51,46 @@ class zoning_process {
 
 	typedef zoning_process_traits::feature_container_type feature_container_type;
 	typedef zoning_process_traits::polygon_type polygon_type;
+	typedef zoning_process_traits::feature_binning_type feature_binning_type;
+	typedef zoning_process_traits::feature_bin_container_type feature_bin_container_type;
 	typedef zoning_process_traits::voronoi_map_type voronoi_map_type;
+	typedef zoning_process_traits::voronoi_construction_type voronoi_construction_type;
 	typedef zoning_process_traits::neighborhood_type neighborhood_type;
 	typedef zoning_process_traits::const_zone_neighbor_range_type const_zone_neighbor_range_type;
 	typedef zoning_process_traits::aggregation_type aggregation_type;
+	typedef zoning_process_traits::fusion_strategy_type fusion_strategy_type;
 	typedef zoning_process_traits::attribute_distance_container_type attribute_distance_container_type;
 	typedef zoning_process_traits::zone_distance_type zone_distance_type;
 	typedef zoning_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef zoning_process_traits::fusion_map_type fusion_map_type;
 	typedef zoning_process_traits::fusion_map_range_type fusion_map_range_type;
 	typedef zoning_process_traits::reverse_fusion_map_range_type reverse_fusion_map_range_type;
+	typedef zoning_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
+	typedef zoning_process_traits::zone_fusion_step_container_list_type zone_fusion_step_container_list_type;
+	typedef zoning_process_traits::fusion_configuration_container_type fusion_configuration_container_type;
+	typedef zoning_process_traits::zoning_quality_container_type zoning_quality_container_type;
 	typedef zoning_process_traits::merge_type merge_type;
 	typedef zoning_process_traits::merge_map_type merge_map_type;
+	typedef zoning_process_traits::zone_geometry_cache_type zone_geometry_cache_type;
+	typedef zoning_process_traits::point_container_type point_container_type;
+	typedef zoning_process_traits::zone_label_container_type zone_label_container_type;
+	typedef zoning_process_traits::raster_grid_type raster_grid_type;
+	typedef zoning_process_traits::raster_label_container_type raster_label_container_type;
+	typedef zoning_process_traits::progress_callback_type progress_callback_type;
+	typedef zoning_process_traits::cancellation_token_type cancellation_token_type;
 
 	boost::movelib::unique_ptr<zoning_process_impl> impl;
 
 public:
 	zoning_process(const feature_container_type &features);
+	zoning_process(feature_container_type &&features);
 	~zoning_process();
 
 	void set_border(const polygon_type &border);
 	polygon_type get_border() const;
+	void set_feature_binning(const feature_binning_type &feature_binning);
+	void set_voronoi_construction(const voronoi_construction_type &voronoi_construction);
+	void set_voronoi_tile_count(size_t voronoi_tile_count);
 	void compute_voronoi_process();
 	void release_voronoi_process();
 	bool is_voronoi_implemented() const;
@@ -78,6 +98,8 @@ public:
 
 	size_t get_unique_feature_size() const;
 	size_t get_bounded_feature_size() const;
+	size_t get_site_feature_size() const;
+	feature_bin_container_type get_feature_bins() const;
 
 	void set_neighborhood(const neighborhood_type &neighborhood);
 	void compute_neighborhood_process();
@@ -87,6 +109,7 @@ public:
 	const_zone_neighbor_range_type get_filtered_zone_neighbors() const;
 
 	void set_aggregation(const aggregation_type &aggregation);
+	void set_fusion_strategy(const fusion_strategy_type &fusion_strategy);
 	void set_zone_distance(const zone_distance_type &zone_distance);
 	void set_multidimensional_distance(const multidimensional_distance_type &multidimensional_distance);
 	void set_attribute_distances(const attribute_distance_container_type &attribute_distances);
@@ -94,8 +117,14 @@ public:
 	void release_fusion_process();
 	bool is_fusion_implemented() const;
 	size_t get_fusion_size() const;
+	size_t get_cut_zone_size(double distance) const;
 	fusion_map_range_type get_fusion_maps(size_t begin, size_t end, bool compute_zones);
 	reverse_fusion_map_range_type get_reverse_fusion_maps(size_t begin, size_t end, bool compute_zones);
+	zone_fusion_step_container_list_type compute_fusion_sweep(const fusion_configuration_container_type &fusion_configurations, size_t thread_count = 0);
+	void restore_fusion_process(const zone_fusion_step_container_type &zone_fusion_steps);
+	zoning_quality_container_type get_fusion_qualities();
+	std::vector<std::string> get_fusion_leaf_ids();
+	void get_fusion_dendrogram(int *merges, double *heights, int *order);
 
 	void set_merge(const merge_type &merge);
 	merge_type get_merge() const;
@@ -104,6 +133,19 @@ public:
 	bool is_merge_implemented() const;
 	size_t get_merge_size() const;
 	merge_map_type get_merge_map(size_t map_index) const;
+	merge_map_type get_merge_map(size_t map_index, double tolerance) const;
+	zone_label_container_type get_merge_map_labels(const point_container_type &points, const std::vector<size_t> &map_indices) const;
+	raster_grid_type get_raster_grid(double cell_size) const;
+	raster_label_container_type get_merge_map_rasters(const raster_grid_type &grid, const std::vector<size_t> &map_indices) const;
+	zoning_quality_container_type get_merge_qualities(const std::vector<size_t> &map_indices) const;
+
+	void set_progress(const progress_callback_type &callback, const cancellation_token_type &cancellation_token);
+	void set_stage_cache_capacity(size_t capacity);
+	void set_zone_geometry_cache_budget(size_t budget);
+	const zone_geometry_cache_type &get_zone_geometry_cache() const;
+
+	void save(std::ostream &stream, bool save_geometries);
+	void load(std::istream &stream);
 };
 
 } // namespace geofis
@@ -37,24 +37,39 @@
  * knowledge of the CeCILL license and that you accept its terms.
  */
 #include <geofis/process/zoning/zoning_process_impl.hpp>
+#include <istream>
+#include <ostream>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
 #include <boost/range/algorithm/stable_sort.hpp>
 #include <boost/range/algorithm/unique.hpp>
 #include <boost/range/algorithm/stable_partition.hpp>
-#include <boost/range/algorithm/for_each.hpp>
-#include <boost/range/algorithm/sort.hpp>
 #include <geofis/geometry/polygon.hpp>
 #include <geofis/geometry/geometrical_comparator.hpp>
 #include <geofis/geometry/geometrical_equal.hpp>
 #include <geofis/geometry/feature_bounded.hpp>
-#include <geofis/identifiable/identifiable_comparator.hpp>
+#include <geofis/algorithm/feature/feature_hilbert_sort.hpp>
 #include <geofis/algorithm/zoning/fusion/aggregation/aggregation_adaptor.hpp>
+#include <geofis/algorithm/zoning/fusion/fusion_dendrogram.hpp>
+#include <geofis/algorithm/zoning/map/map_simplification.hpp>
+#include <util/thread/thread_pool.hpp>
+#include <util/cache/content_hasher.hpp>
 
 using namespace util;
 using namespace boost;
 
 namespace geofis {
 
-zoning_process_impl::zoning_process_impl(const feature_container_type &features) : features(features) {
+zoning_process_impl::zoning_process_impl(const feature_container_type &features) : features(features), voronoi_tile_count(0), bounded_feature_key(0), voronoi_key(0), zone_neighbor_key(0), voronoi_cache(default_stage_cache_capacity), fusion_cache(default_stage_cache_capacity), geometry_cache(default_zone_geometry_cache_budget) {
+	initialize_features();
+}
+
+zoning_process_impl::zoning_process_impl(feature_container_type &&features) : features(std::move(features)), voronoi_tile_count(0), bounded_feature_key(0), voronoi_key(0), zone_neighbor_key(0), voronoi_cache(default_stage_cache_capacity), fusion_cache(default_stage_cache_capacity), geometry_cache(default_zone_geometry_cache_budget) {
 	initialize_features();
 }
 
@@ -68,23 +83,220 @@ void zoning_process_impl::initialize_features() {
 	unique_features = unique<return_begin_found>(features, geometrical_equal());
 }
 
+template <class Writer, class Strategy> static void write_strategy(Writer &writer, const Strategy &strategy) {
+	writer.write(uint32_t(strategy.which()));
+	writer.write(uint32_t(0));
+	writer.write(apply_visitor(zoning_checkpoint_parameter(), strategy));
+}
+
+struct fuzzy_attribute_distance_visitor : public static_visitor<bool> {
+
+	bool operator()(const fispro::fuzzy_distance &) const {
+		return true;
+	}
+
+	template <class AttributeDistance> bool operator()(const AttributeDistance &) const {
+		return false;
+	}
+};
+
+template <class AttributeDistanceContainer> static bool has_fuzzy_attribute_distance(const AttributeDistanceContainer &attribute_distances) {
+	return std::any_of(attribute_distances.begin(), attribute_distances.end(), [](const typename AttributeDistanceContainer::value_type &attribute_distance) {
+		return apply_visitor(fuzzy_attribute_distance_visitor(), attribute_distance);
+	});
+}
+
+template <class Writer, class Aggregation, class FusionStrategy, class ZoneDistance, class MultidimensionalDistance, class AttributeDistanceContainer> static void write_fusion_configuration(Writer &writer, const Aggregation &aggregation, const FusionStrategy &fusion_strategy, const ZoneDistance &zone_distance, const MultidimensionalDistance &multidimensional_distance, const AttributeDistanceContainer &attribute_distances) {
+	write_strategy(writer, aggregation);
+	write_strategy(writer, fusion_strategy);
+	write_strategy(writer, zone_distance);
+	write_strategy(writer, multidimensional_distance);
+	writer.write(uint64_t(attribute_distances.size()));
+	for(const auto &attribute_distance : attribute_distances)
+		write_strategy(writer, attribute_distance);
+}
+
+/**
+ * The bounded features are hashed one by one and their sorted hashes are hashed with the border, so the key does not
+ * depend on the storage order of the features, which is left by the previous borders.
+ */
+void zoning_process_impl::initialize_bounded_feature_key() {
+	std::vector<uint64_t> feature_keys;
+	feature_keys.reserve(get_bounded_feature_size());
+	for(const auto &feature : bounded_features) {
+		content_hasher feature_hasher;
+		feature_hasher.write_string(feature.get_id());
+		feature_hasher.write(CGAL::to_double(feature.get_geometry().x()));
+		feature_hasher.write(CGAL::to_double(feature.get_geometry().y()));
+		feature_keys.push_back(feature_hasher.get_hash());
+	}
+	std::sort(feature_keys.begin(), feature_keys.end());
+	content_hasher hasher;
+	hasher.write(uint64_t(border.size()));
+	for(auto vertex = border.vertices_begin(); vertex != border.vertices_end(); ++vertex) {
+		hasher.write(CGAL::to_double(vertex->x()));
+		hasher.write(CGAL::to_double(vertex->y()));
+	}
+	hasher.write(uint64_t(feature_keys.size()));
+	hasher.write_range(feature_keys);
+	bounded_feature_key = hasher.get_hash();
+}
+
+uint64_t zoning_process_impl::get_voronoi_key() const {
+	content_hasher hasher;
+	hasher.write(bounded_feature_key);
+	write_strategy(hasher, feature_binning);
+	write_strategy(hasher, voronoi_construction);
+	return hasher.get_hash();
+}
+
+/**
+ * The fusion depends on the voronoi zones, on the retained zone neighbors, on the fusion strategy and on the distance
+ * configuration. The neighborhood is not part of the key: neighborhoods retaining the same zone neighbors share their
+ * fusions.
+ */
+uint64_t zoning_process_impl::get_fusion_key(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const attribute_distance_container_type &attribute_distances) const {
+	content_hasher hasher;
+	hasher.write(voronoi_key);
+	hasher.write(zone_neighbor_key);
+	write_fusion_configuration(hasher, aggregation, fusion_strategy, zone_distance, multidimensional_distance, attribute_distances);
+	return hasher.get_hash();
+}
+
 void zoning_process_impl::set_border(const polygon_type &border) {
 	UTIL_REQUIRE(is_valid_polygon(border));
 	this->border = border;
-	bounded_features = stable_partition<return_begin_found>(unique_features, make_feature_bounded(border));
-	sort(bounded_features, identifiable_comparator());
+	polygon_slab_index<zoning_process_traits::kernel_type> border_index(border);
+	bounded_features = stable_partition<return_begin_found>(unique_features, make_feature_bounded(border_index));
+	initialize_bounded_feature_key();
+	hilbert_sort_features(bounded_features);
+	initialize_site_features();
 }
 
 zoning_process_impl::polygon_type zoning_process_impl::get_border() const {
 	return border;
 }
 
+/**
+ * Sets the binning of the bounded features, the occupied cells of the binning being the sites of the voronoi zones
+ * instead of the bounded features. The binning is part of the voronoi key.
+ */
+void zoning_process_impl::set_feature_binning(const feature_binning_type &feature_binning) {
+	this->feature_binning = feature_binning;
+	initialize_site_features();
+}
+
+struct feature_binning_visitor : public boost::static_visitor<bool> {
+
+	typedef zoning_process_traits::feature_range_type feature_range_type;
+	typedef zoning_process_traits::feature_container_type feature_container_type;
+
+	feature_binning_visitor(const feature_range_type &features, feature_container_type &site_features, std::vector<size_t> &feature_bins, std::vector<size_t> &bin_sizes) : features(features), site_features(site_features), feature_bins(feature_bins), bin_sizes(bin_sizes) {}
+
+	bool operator()(const no_feature_binning &) const {
+		return false;
+	}
+
+	template <class Binning> bool operator()(const Binning &binning) const {
+		bin_features(features, binning, site_features, feature_bins, bin_sizes);
+		return true;
+	}
+
+	const feature_range_type &features;
+	feature_container_type &site_features;
+	std::vector<size_t> &feature_bins;
+	std::vector<size_t> &bin_sizes;
+};
+
+/**
+ * The site features are the bounded features without binning, and the site features of the occupied cells with
+ * binning. Each bounded feature is its own bin without binning.
+ */
+void zoning_process_impl::initialize_site_features() {
+	if(apply_visitor(feature_binning_visitor(bounded_features, binned_features, feature_bins, bin_sizes), feature_binning)) {
+		site_features = binned_features;
+	} else {
+		feature_container_type().swap(binned_features);
+		feature_bins.resize(get_bounded_feature_size());
+		std::iota(feature_bins.begin(), feature_bins.end(), size_t(0));
+		bin_sizes.assign(get_bounded_feature_size(), 1);
+		site_features = bounded_features;
+	}
+}
+
+/**
+ * Sets the label of each site feature in a merge map, the label being the 1-based index of the zone of the site.
+ */
+void zoning_process_impl::initialize_site_labels(size_t map_index, std::vector<size_t> &site_labels) const {
+	const zoning_process_traits::feature_type *first_site_feature = &*boost::begin(site_features);
+	merge_map_type merge_map = get_merge_map(map_index);
+	size_t label = 0;
+	for(const auto &zone : merge_map.get_zones()) {
+		++label;
+		for(const auto &voronoi_zone : zone.get_voronoi_zones())
+			site_labels[&voronoi_zone.get_feature() - first_site_feature] = label;
+	}
+}
+
+void zoning_process_impl::set_voronoi_construction(const voronoi_construction_type &voronoi_construction) {
+	this->voronoi_construction = voronoi_construction;
+}
+
+/**
+ * Sets the number of tiles along each side of the extent of the bounded features, the voronoi geometries being
+ * computed by tiles when there are more than one. The tiling does not change the geometries, it is not part of the
+ * voronoi key.
+ */
+void zoning_process_impl::set_voronoi_tile_count(size_t voronoi_tile_count) {
+	this->voronoi_tile_count = voronoi_tile_count;
+}
+
+/**
+ * The voronoi geometries of the last computed keys are cached, a cached voronoi is restored from its geometries
+ * without computing any voronoi cell.
+ */
 void zoning_process_impl::compute_voronoi_process() {
-	voronoi_process_type _voronoi_process(bounded_features, border);
+	geometry_cache.clear();
+	try {
+		uint64_t voronoi_key = get_voronoi_key();
+		if(const polygon_container_type *geometries = voronoi_cache.find(voronoi_key)) {
+			voronoi_process_type _voronoi_process(site_features, *geometries);
+			this->_voronoi_process = boost::move(_voronoi_process);
+		} else {
+			if(voronoi_tile_count > 1) {
+				voronoi_process_type _voronoi_process(site_features, border, voronoi_construction, voronoi_tile_count, progress);
+				this->_voronoi_process = boost::move(_voronoi_process);
+			} else {
+				voronoi_process_type _voronoi_process(site_features, border, voronoi_construction, progress);
+				this->_voronoi_process = boost::move(_voronoi_process);
+			}
+			if(voronoi_cache.get_capacity())
+				voronoi_cache.insert(voronoi_key, get_voronoi_geometries());
+		}
+		this->voronoi_key = voronoi_key;
+	} catch(...) {
+		release_voronoi_process();
+		throw;
+	}
+}
+
+void zoning_process_impl::restore_voronoi_process(const polygon_container_type &geometries) {
+	voronoi_process_type _voronoi_process(site_features, geometries);
 	this->_voronoi_process = boost::move(_voronoi_process);
+	voronoi_key = get_voronoi_key();
+	voronoi_cache.insert(voronoi_key, geometries);
+}
+
+zoning_process_impl::polygon_container_type zoning_process_impl::get_voronoi_geometries() const {
+	polygon_container_type geometries;
+	geometries.reserve(get_site_feature_size());
+	for(const auto &voronoi_zone : get_voronoi_map().get_zones())
+		geometries.push_back(voronoi_zone.get_geometry());
+	return geometries;
 }
 
 void zoning_process_impl::release_voronoi_process() {
+	geometry_cache.clear();
 	voronoi_process_type _voronoi_process;
 	this->_voronoi_process = boost::move(_voronoi_process);
 }
@@ -104,6 +316,13 @@ void zoning_process_impl::set_neighborhood(const neighborhood_type &neighborhood
 void zoning_process_impl::compute_neighborhood_process() {
 	neighborhood_process_type _neighborhood_process(neighborhood, _voronoi_process.get_finite_edges());
 	this->_neighborhood_process = boost::move(_neighborhood_process);
+	content_hasher hasher;
+	hasher.write(uint64_t(boost::size(get_zone_neighbors())));
+	for(const auto &zone_index_pair : get_zone_index_pairs(get_zone_neighbors())) {
+		hasher.write(zone_index_pair.first);
+		hasher.write(zone_index_pair.second);
+	}
+	zone_neighbor_key = hasher.get_hash();
 }
 
 void zoning_process_impl::release_neighborhood_process() {
@@ -127,6 +346,10 @@ void zoning_process_impl::set_aggregation(const aggregation_type &aggregation) {
 	this->aggregation = aggregation;
 }
 
+void zoning_process_impl::set_fusion_strategy(const fusion_strategy_type &fusion_strategy) {
+	this->fusion_strategy = fusion_strategy;
+}
+
 void zoning_process_impl::set_zone_distance(const zone_distance_type &zone_distance) {
 	this->zone_distance = zone_distance;
 }
@@ -139,12 +362,39 @@ void zoning_process_impl::set_attribute_distances(const attribute_distance_conta
 	this->attribute_distances = attribute_distances;
 }
 
+/**
+ * The fusion steps of the last computed keys are cached, a cached fusion is restored from its steps without computing
+ * any distance. The fusions with fuzzy attribute distances are not cached, as the key does not hold the partitions of
+ * the fuzzy distances.
+ */
 void zoning_process_impl::compute_fusion_process() {
-	fusion_process_type _fusion_process(aggregation, zone_distance, multidimensional_distance, attribute_distances, bounded_features, _neighborhood_process.get_zone_neighbors());
-	this->_fusion_process = boost::move(_fusion_process);
+	geometry_cache.clear();
+	try {
+		bool is_cached = fusion_cache.get_capacity() && !has_fuzzy_attribute_distance(attribute_distances);
+		uint64_t fusion_key = is_cached ? get_fusion_key(aggregation, zone_distance, multidimensional_distance, attribute_distances) : 0;
+		if(const zone_fusion_step_container_type *zone_fusion_steps = is_cached ? fusion_cache.find(fusion_key) : nullptr) {
+			fusion_process_type _fusion_process(aggregation, attribute_distances, site_features, _voronoi_process.get_zones(), *zone_fusion_steps);
+			this->_fusion_process = boost::move(_fusion_process);
+		} else if(boost::get<spanning_tree_fusion>(&fusion_strategy)) {
+			spanning_tree_process_type _spanning_tree_process(multidimensional_distance, attribute_distances, site_features, _voronoi_process.get_zones(), _neighborhood_process.get_zone_neighbors(), progress);
+			fusion_process_type _fusion_process(aggregation, attribute_distances, site_features, _voronoi_process.get_zones(), _spanning_tree_process.get_fusion_steps());
+			this->_fusion_process = boost::move(_fusion_process);
+			if(is_cached)
+				fusion_cache.insert(fusion_key, _spanning_tree_process.get_fusion_steps());
+		} else {
+			fusion_process_type _fusion_process(aggregation, fusion_strategy, zone_distance, multidimensional_distance, attribute_distances, site_features, _neighborhood_process.get_zone_neighbors(), progress);
+			this->_fusion_process = boost::move(_fusion_process);
+			if(is_cached)
+				fusion_cache.insert(fusion_key, this->_fusion_process.get_fusion_steps(_voronoi_process.get_zones()));
+		}
+	} catch(...) {
+		release_fusion_process();
+		throw;
+	}
 }
 
 void zoning_process_impl::release_fusion_process() {
+	geometry_cache.clear();
 	fusion_process_type _fusion_process;
 	this->_fusion_process = boost::move(_fusion_process);
 }
@@ -157,10 +407,162 @@ size_t zoning_process_impl::get_fusion_size() const {
 	return _fusion_process.get_fusion_size();
 }
 
+/**
+ * Returns the number of zones of the fusion cut at the distance, the zones of the voronoi zones merged by the fusions
+ * whose distances, and the distances of the previous fusions, do not exceed the distance.
+ */
+size_t zoning_process_impl::get_cut_zone_size(double distance) const {
+	UTIL_REQUIRE(is_fusion_implemented());
+	return get_site_feature_size() - _fusion_process.get_cut_fusion_size(distance);
+}
+
 zoning_process_impl::fusion_map_range_type zoning_process_impl::get_fusion_maps(size_t begin, size_t end, bool compute_zones) {
 	return _fusion_process.get_fusion_maps(_voronoi_process.get_zones(), begin, end, compute_zones);
 }
 
+/**
+ * Computes the fusion of each configuration with the voronoi zones, the zone neighbors and the fusion strategy of the
+ * zoning, the fusions being independent they are computed concurrently. Returns the fusion steps of each
+ * configuration, which can be restored with restore_fusion_process once the zoning is set with the configuration. The
+ * zoning fusion stage is left unchanged, and the progress is not reported. The fusion steps are cached, so computing
+ * the fusion of a swept configuration restores it, except with fuzzy attribute distances.
+ *
+ * The shared data are only read by the fusions: the areas of the voronoi zones are computed before, and the
+ * normalized attributes of the site features are written in place before, as by compute_fusion_process, from their
+ * attributes, the min-max normalization of each attribute being the same for every configuration. Each fusion
+ * normalizes its own copy of the attribute distances.
+ */
+zoning_process_impl::zone_fusion_step_container_list_type zoning_process_impl::compute_fusion_sweep(const fusion_configuration_container_type &fusion_configurations, size_t thread_count) {
+	UTIL_REQUIRE(is_neighborhood_implemented());
+	fusion_process_type::normalize_features(site_features);
+	const zone_info_policy_type &zones = _voronoi_process.get_zones();
+	for(const zone_type &zone : zones)
+		zone.get_area();
+	fusion_configuration_container_type configurations(fusion_configurations);
+	zone_neighbor_range_type zone_neighbors = _neighborhood_process.get_zone_neighbors();
+	zone_fusion_step_container_list_type zone_fusion_sweep(configurations.size());
+	thread_pool(thread_count ? thread_count : thread_pool::default_thread_count()).run(configurations.size(), [&](size_t index) {
+		fusion_configuration_type &configuration = configurations[index];
+		progress_monitor_type fusion_progress;
+		if(boost::get<spanning_tree_fusion>(&fusion_strategy)) {
+			spanning_tree_process_type spanning_tree(configuration.multidimensional_distance, configuration.attribute_distances, zones, zone_neighbors, fusion_progress);
+			zone_fusion_sweep[index] = spanning_tree.get_fusion_steps();
+		} else {
+			fusion_process_type fusion(configuration.aggregation, fusion_strategy, configuration.zone_distance, configuration.multidimensional_distance, configuration.attribute_distances, zone_neighbors, fusion_progress);
+			zone_fusion_sweep[index] = fusion.get_fusion_steps(zones);
+		}
+	});
+	for(size_t index = 0; index < configurations.size(); ++index) {
+		const fusion_configuration_type &configuration = fusion_configurations[index];
+		if(!has_fuzzy_attribute_distance(configuration.attribute_distances))
+			fusion_cache.insert(get_fusion_key(configuration.aggregation, configuration.zone_distance, configuration.multidimensional_distance, configuration.attribute_distances), zone_fusion_sweep[index]);
+	}
+	return zone_fusion_sweep;
+}
+
+/**
+ * Restores the fusion stage from fusion steps computed with the zoning configuration, without computing any distance.
+ */
+void zoning_process_impl::restore_fusion_process(const zone_fusion_step_container_type &zone_fusion_steps) {
+	geometry_cache.clear();
+	fusion_process_type _fusion_process(aggregation, attribute_distances, site_features, _voronoi_process.get_zones(), zone_fusion_steps);
+	this->_fusion_process = boost::move(_fusion_process);
+	if(!has_fuzzy_attribute_distance(attribute_distances))
+		fusion_cache.insert(get_fusion_key(aggregation, zone_distance, multidimensional_distance, attribute_distances), zone_fusion_steps);
+}
+
+/**
+ * Returns the moments of the bounded features of each bin, by site index. With binning, the moments of a site are
+ * those of the data points of its cell, not of its mean attributes, so that the quality indices are computed on the
+ * data points whatever the binning.
+ */
+std::vector<zone_moments> zoning_process_impl::get_site_moments() const {
+	std::vector<zone_moments> site_moments;
+	site_moments.reserve(get_site_feature_size());
+	size_t feature_index = 0;
+	for(const auto &feature : bounded_features) {
+		size_t bin = feature_bins[feature_index++];
+		// the bins are ordered by their first feature
+		if(bin == site_moments.size())
+			site_moments.push_back(zone_moments(feature.get_attribute_range()));
+		else
+			site_moments[bin] = zone_moments(site_moments[bin], zone_moments(feature.get_attribute_range()));
+	}
+	return site_moments;
+}
+
+zone_moments zoning_process_impl::get_zone_moments(const std::vector<zone_moments> &site_moments, const zone_type &zone) const {
+	const zoning_process_traits::feature_type *first_site_feature = &*boost::begin(site_features);
+	auto voronoi_zones = zone.get_voronoi_zones();
+	auto voronoi_zone = boost::begin(voronoi_zones);
+	zone_moments moments = site_moments[&voronoi_zone->get_feature() - first_site_feature];
+	while(++voronoi_zone != boost::end(voronoi_zones))
+		moments = zone_moments(moments, site_moments[&voronoi_zone->get_feature() - first_site_feature]);
+	return moments;
+}
+
+// the accumulator of the zoning of the zones
+static zoning_quality_accumulator make_quality_accumulator(const std::vector<zone_moments> &moments) {
+	zone_moments total_moments = moments.front();
+	for(size_t index = 1; index < moments.size(); ++index)
+		total_moments = zone_moments(total_moments, moments[index]);
+	zoning_quality_accumulator accumulator(total_moments);
+	for(const zone_moments &zone : moments)
+		accumulator.add_zone(zone);
+	return accumulator;
+}
+
+/**
+ * Walks the fusion steps once from the voronoi zones, the moments of the fusion zone of each step being merged from
+ * the moments of its two zones. Returns the quality of the zoning of each fusion step, by increasing number of zones.
+ */
+zoning_process_impl::zoning_quality_container_type zoning_process_impl::get_fusion_qualities() {
+	UTIL_REQUIRE(is_fusion_implemented());
+	const zone_info_policy_type &zones = _voronoi_process.get_zones();
+	zone_fusion_step_container_type zone_fusion_steps = _fusion_process.get_fusion_steps(zones);
+	std::vector<zone_moments> site_moments = get_site_moments();
+	std::vector<zone_moments> moments;
+	moments.reserve(boost::size(zones) + zone_fusion_steps.size());
+	for(const zone_type &zone : zones)
+		moments.push_back(get_zone_moments(site_moments, zone));
+	zoning_quality_container_type qualities;
+	if(moments.empty())
+		return qualities;
+	zoning_quality_accumulator accumulator = make_quality_accumulator(moments);
+	qualities.reserve(zone_fusion_steps.size() + 1);
+	qualities.push_back(accumulator.get_quality());
+	for(const zone_fusion_step &zone_fusion_step : zone_fusion_steps) {
+		accumulator.remove_zone(moments[zone_fusion_step.zone1]);
+		accumulator.remove_zone(moments[zone_fusion_step.zone2]);
+		moments.push_back(zone_moments(moments[zone_fusion_step.zone1], moments[zone_fusion_step.zone2]));
+		accumulator.add_zone(moments.back());
+		qualities.push_back(accumulator.get_quality());
+	}
+	std::reverse(qualities.begin(), qualities.end());
+	return qualities;
+}
+
+/**
+ * Returns the ids of the voronoi zones, the leaves of the fusion dendrogram, in the order of the zones of the fusion
+ * steps.
+ */
+std::vector<std::string> zoning_process_impl::get_fusion_leaf_ids() {
+	std::vector<std::string> leaf_ids;
+	leaf_ids.reserve(get_site_feature_size());
+	for(const zone_type &zone : _voronoi_process.get_zones())
+		leaf_ids.push_back(zone.get_id());
+	return leaf_ids;
+}
+
+/**
+ * Writes the complete fusion as a hclust dendrogram in the given arrays, of (site size - 1) x 2 merges, (site size - 1)
+ * heights and site size leaves, in one pass over the fusion steps.
+ */
+void zoning_process_impl::get_fusion_dendrogram(int *merges, double *heights, int *order) {
+	UTIL_REQUIRE(is_fusion_implemented());
+	write_fusion_dendrogram(get_site_feature_size(), _fusion_process.get_fusion_steps(_voronoi_process.get_zones()), merges, heights, order);
+}
+
 size_t zoning_process_impl::get_unique_feature_size() const {
 	return distance(unique_features);
 }
@@ -169,6 +571,24 @@ size_t zoning_process_impl::get_bounded_feature_size() const {
 	return distance(bounded_features);
 }
 
+size_t zoning_process_impl::get_site_feature_size() const {
+	return distance(site_features);
+}
+
+/**
+ * Returns the bin of each bounded feature, in the storage order of the bounded features.
+ */
+zoning_process_impl::feature_bin_container_type zoning_process_impl::get_feature_bins() const {
+	feature_bin_container_type bins;
+	bins.reserve(get_bounded_feature_size());
+	size_t feature_index = 0;
+	for(const auto &feature : bounded_features) {
+		size_t bin = feature_bins[feature_index++];
+		bins.push_back(feature_bin_type(feature.get_id(), boost::begin(site_features)[bin].get_id(), bin_sizes[bin]));
+	}
+	return bins;
+}
+
 void zoning_process_impl::set_merge(const merge_type &merge) {
 	this->merge = merge;
 }
@@ -198,7 +618,450 @@ size_t zoning_process_impl::get_merge_size() const {
 }
 
 zoning_process_impl::merge_map_type zoning_process_impl::get_merge_map(size_t map_index) const {
-	return _merge_process.get_merge_map(map_index, neighborhood, aggregation, zone_distance, multidimensional_distance, attribute_distances);
+	return _merge_process.get_merge_map(map_index, neighborhood, aggregation, zone_distance, multidimensional_distance, attribute_distances, progress);
+}
+
+/**
+ * The geometries of the zones of the fusion dendrogram are read from the zone geometry cache or computed and cached.
+ */
+zoning_process_impl::merge_map_type zoning_process_impl::get_merge_map(size_t map_index, double tolerance) const {
+	merge_map_type merge_map = geometry_cache.load_geometries(get_merge_map(map_index), _merge_process.get_fusion_map(map_index).get_zones());
+	if(tolerance > 0)
+		return simplify_map(merge_map, tolerance);
+	return merge_map;
+}
+
+struct point_coordinate_hash {
+
+	size_t operator()(const std::pair<double, double> &coordinates) const {
+		size_t hash = std::hash<double>()(coordinates.first);
+		return hash ^ (std::hash<double>()(coordinates.second) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+	}
+};
+
+// the zero is added so that -0.0 and 0.0 have the same hash
+static std::pair<double, double> get_point_coordinates(const zoning_process_traits::point_type &point) {
+	return std::make_pair(CGAL::to_double(point.x()) + 0.0, CGAL::to_double(point.y()) + 0.0);
+}
+
+/**
+ * Returns the zone labels of the points in the merge maps, as a column-major matrix with one row per point and one
+ * column per map index. The label is the 1-based index of the zone in the merge map, a point located on a bounded
+ * feature, a duplicate included, gets the label of this feature and a point outside the border is labelled 0.
+ *
+ * The labels are read from the membership of the voronoi zones in the merge zones, a voronoi zone referring to its
+ * site feature, without computing any zone geometry.
+ */
+zoning_process_impl::zone_label_container_type zoning_process_impl::get_merge_map_labels(const point_container_type &points, const std::vector<size_t> &map_indices) const {
+	UTIL_REQUIRE(is_merge_implemented());
+	std::unordered_map<std::pair<double, double>, size_t, point_coordinate_hash> feature_indices;
+	feature_indices.reserve(get_bounded_feature_size());
+	for(const auto &feature : bounded_features)
+		feature_indices.emplace(get_point_coordinates(feature.get_geometry()), feature_indices.size());
+	std::vector<size_t> point_features;
+	point_features.reserve(points.size());
+	for(const auto &point : points) {
+		auto feature_index = feature_indices.find(get_point_coordinates(point));
+		point_features.push_back(feature_index == feature_indices.end() ? get_bounded_feature_size() : feature_index->second);
+	}
+	std::vector<size_t> site_labels(get_site_feature_size());
+	zone_label_container_type labels;
+	labels.reserve(points.size() * map_indices.size());
+	for(size_t map_index : map_indices) {
+		initialize_site_labels(map_index, site_labels);
+		for(size_t feature_index : point_features)
+			labels.push_back(feature_index < feature_bins.size() ? site_labels[feature_bins[feature_index]] : 0);
+	}
+	return labels;
+}
+
+/**
+ * Returns the grid covering the extent of the border with square cells of the given size.
+ */
+zoning_process_impl::raster_grid_type zoning_process_impl::get_raster_grid(double cell_size) const {
+	return make_raster_grid(border.bbox(), cell_size);
+}
+
+/**
+ * Returns the zone labels of the grid cells in the merge maps, the cells of a map being stored column by column and
+ * the maps one after the other. The label of a cell is the 1-based index in the merge map of the zone containing the
+ * center of the cell, a cell whose center is outside the border being labelled 0.
+ *
+ * The site of each cell is located once in the delaunay triangulation of the voronoi map, the labels of the sites in
+ * all the maps being read from the merge membership beforehand, so the maps are rasterized in one pass over the grid.
+ */
+zoning_process_impl::raster_label_container_type zoning_process_impl::get_merge_map_rasters(const raster_grid_type &grid, const std::vector<size_t> &map_indices) const {
+	UTIL_REQUIRE(is_voronoi_implemented() && is_merge_implemented());
+	size_t map_size = map_indices.size();
+	std::vector<uint32_t> site_map_labels(get_site_feature_size() * map_size);
+	std::vector<size_t> site_labels(get_site_feature_size());
+	for(size_t map = 0; map < map_size; ++map) {
+		initialize_site_labels(map_indices[map], site_labels);
+		for(size_t site = 0; site < site_labels.size(); ++site)
+			site_map_labels[site * map_size + map] = uint32_t(site_labels[site]);
+	}
+	const zoning_process_traits::feature_type *first_site_feature = &*boost::begin(site_features);
+	raster_label_container_type labels(grid.size() * map_size, 0);
+	polygon_slab_index<kernel_type> border_index(border);
+	scan_raster_zones(grid, _voronoi_process.get_voronoi_map(), border_index, [&](size_t cell, const zoning_process_traits::voronoi_zone_type &voronoi_zone) {
+		const uint32_t *cell_labels = &site_map_labels[(&voronoi_zone.get_feature() - first_site_feature) * map_size];
+		for(size_t map = 0; map < map_size; ++map)
+			labels[map * grid.size() + cell] = cell_labels[map];
+	});
+	return labels;
+}
+
+/**
+ * Returns the quality of the merge maps of the indices, each merge map being computed without its geometries to merge
+ * its small zones to their neighbors.
+ */
+zoning_process_impl::zoning_quality_container_type zoning_process_impl::get_merge_qualities(const std::vector<size_t> &map_indices) const {
+	UTIL_REQUIRE(is_merge_implemented());
+	std::vector<zone_moments> site_moments = get_site_moments();
+	zoning_quality_container_type qualities;
+	qualities.reserve(map_indices.size());
+	for(size_t map_index : map_indices) {
+		merge_map_type merge_map = get_merge_map(map_index);
+		std::vector<zone_moments> moments;
+		for(const zone_type &zone : merge_map.get_zones())
+			moments.push_back(get_zone_moments(site_moments, zone));
+		qualities.push_back(make_quality_accumulator(moments).get_quality());
+	}
+	return qualities;
+}
+
+/**
+ * The callback and the cancellation token are used by the voronoi and the fusion stages, and by the merge maps.
+ * A cancelled stage is released.
+ */
+void zoning_process_impl::set_progress(const progress_callback_type &callback, const cancellation_token_type &cancellation_token) {
+	progress = progress_monitor_type(callback, cancellation_token);
+}
+
+/**
+ * Sets the number of voronoi and fusion results kept for each stage, a zero capacity disables the cache.
+ */
+void zoning_process_impl::set_stage_cache_capacity(size_t capacity) {
+	voronoi_cache.set_capacity(capacity);
+	fusion_cache.set_capacity(capacity);
+}
+
+/**
+ * Sets the bytes of the zone geometries kept for the merge maps, a zero budget disables the cache.
+ */
+void zoning_process_impl::set_zone_geometry_cache_budget(size_t budget) {
+	geometry_cache.set_budget(budget);
+}
+
+const zoning_process_impl::zone_geometry_cache_type &zoning_process_impl::get_zone_geometry_cache() const {
+	return geometry_cache;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef CGAL::Fraction_traits<CGAL::Epeck_ft> exact_fraction_traits;
+typedef exact_fraction_traits::Numerator_type exact_numerator_type;
+
+/**
+ * Splits the numerator or the denominator of an exact coordinate into doubles summing to it, the largest first. The
+ * value is not split when it needs more than max_exact_term_size doubles, or doubles out of range.
+ */
+static const size_t max_exact_term_size = 255;
+
+static bool split_exact_terms(exact_numerator_type value, std::vector<double> &terms) {
+	for(size_t term_size = 0; !CGAL::is_zero(value); ++term_size) {
+		double term = CGAL::to_double(value);
+		if(term_size == max_exact_term_size || term == 0 || !std::isfinite(term))
+			return false;
+		terms.push_back(term);
+		value -= exact_numerator_type(term);
+	}
+	return true;
+}
+
+/**
+ * Divides the numerator and the denominator of an exact coordinate by the same power of two until they are in the
+ * double range, as the quotients are not normalized by every number type. Returns false when the number type is not
+ * a binary floating point type, the division being then inexact.
+ */
+static bool scale_exact_fraction(exact_numerator_type &numerator, exact_numerator_type &denominator) {
+	while(!std::isfinite(CGAL::to_double(numerator)) || !std::isfinite(CGAL::to_double(denominator))) {
+		const exact_numerator_type scale(std::ldexp(1.0, -512));
+		if(CGAL::is_zero(scale))
+			return false;
+		numerator *= scale;
+		denominator *= scale;
+	}
+	return true;
+}
+
+static exact_numerator_type sum_exact_terms(const double *terms, size_t term_size) {
+	exact_numerator_type value(0);
+	for(const double *term = terms; term != terms + term_size; ++term)
+		value += exact_numerator_type(*term);
+	return value;
+}
+
+static void write_vertices(zoning_checkpoint_writer &writer, const zoning_process_traits::polygon_type &polygon) {
+	for(auto vertex = polygon.vertices_begin(); vertex != polygon.vertices_end(); ++vertex) {
+		writer.write(CGAL::to_double(vertex->x()));
+		writer.write(CGAL::to_double(vertex->y()));
+	}
+}
+
+/**
+ * Saves the computed stages up to the fusion. The configuration, the features and the border are saved to check
+ * that the checkpoint is loaded into the same zoning, the voronoi geometries are optional. The fuzzy attribute
+ * distances are not saved, as their partitions could not be checked.
+ */
+void zoning_process_impl::save(std::ostream &stream, bool save_geometries) {
+	UTIL_REQUIRE(is_fusion_implemented());
+	if(has_fuzzy_attribute_distance(attribute_distances))
+		throw zoning_checkpoint_error("a zoning with fuzzy attribute distances can not be saved");
+	zoning_checkpoint_writer writer;
+	save_configuration(writer);
+	save_features(writer);
+	save_border(writer);
+	if(save_geometries)
+		this->save_geometries(writer);
+	save_neighbors(writer);
+	save_fusion_steps(writer);
+	writer.flush(stream);
+}
+
+/**
+ * Restores the stages saved by save, the zoning must have the features, the border and the configuration of the
+ * saved zoning. The merge stage is released, it is computed from the restored fusion. The voronoi stage is computed
+ * when the checkpoint has no geometries.
+ */
+void zoning_process_impl::load(std::istream &stream) {
+	zoning_checkpoint_reader reader(stream);
+	check_section(reader, zoning_checkpoint_format::configuration_tag, &zoning_process_impl::save_configuration, "configuration");
+	check_section(reader, zoning_checkpoint_format::feature_tag, &zoning_process_impl::save_features, "features");
+	check_section(reader, zoning_checkpoint_format::border_tag, &zoning_process_impl::save_border, "border");
+	polygon_container_type geometries;
+	if(reader.has_section(zoning_checkpoint_format::cell_tag))
+		geometries = load_geometries(reader.get_section(zoning_checkpoint_format::cell_tag));
+	zone_fusion_step_container_type zone_fusion_steps = load_fusion_steps(reader.get_section(zoning_checkpoint_format::fusion_tag));
+	release_merge_process();
+	release_fusion_process();
+	release_neighborhood_process();
+	release_voronoi_process();
+	try {
+		restore_stages(reader, geometries, zone_fusion_steps);
+	} catch(...) {
+		release_fusion_process();
+		release_neighborhood_process();
+		release_voronoi_process();
+		throw;
+	}
+}
+
+void zoning_process_impl::restore_stages(const zoning_checkpoint_reader &reader, const polygon_container_type &geometries, const zone_fusion_step_container_type &zone_fusion_steps) {
+	if(geometries.empty())
+		compute_voronoi_process();
+	else
+		restore_voronoi_process(geometries);
+	compute_neighborhood_process();
+	check_section(reader, zoning_checkpoint_format::neighbor_tag, &zoning_process_impl::save_neighbors, "neighbors");
+	restore_fusion_process(zone_fusion_steps);
+}
+
+void zoning_process_impl::check_section(const zoning_checkpoint_reader &reader, uint32_t tag, void (zoning_process_impl::*save_section)(zoning_checkpoint_writer &), const std::string &name) {
+	zoning_checkpoint_writer writer;
+	(this->*save_section)(writer);
+	if(reader.get_payload(tag) != writer.get_payload(tag))
+		throw zoning_checkpoint_error(name + " do not match the zoning");
+}
+
+void zoning_process_impl::save_configuration(zoning_checkpoint_writer &writer) {
+	writer.begin_section(zoning_checkpoint_format::configuration_tag);
+	write_strategy(writer, feature_binning);
+	write_strategy(writer, voronoi_construction);
+	write_strategy(writer, neighborhood);
+	write_fusion_configuration(writer, aggregation, fusion_strategy, zone_distance, multidimensional_distance, attribute_distances);
+}
+
+void zoning_process_impl::save_features(zoning_checkpoint_writer &writer) {
+	uint64_t attribute_size = features.empty() ? 0 : features.front().get_attribute_size();
+	writer.begin_section(zoning_checkpoint_format::feature_tag);
+	writer.write(uint64_t(features.size()));
+	writer.write(uint64_t(get_unique_feature_size()));
+	writer.write(uint64_t(get_bounded_feature_size()));
+	writer.write(attribute_size);
+	for(const auto &feature : features) {
+		writer.write(CGAL::to_double(feature.get_geometry().x()));
+		writer.write(CGAL::to_double(feature.get_geometry().y()));
+	}
+	for(const auto &feature : features) {
+		UTIL_REQUIRE(feature.get_attribute_size() == attribute_size);
+		writer.write_range(feature.get_attribute_range());
+	}
+	uint64_t id_offset = 0;
+	writer.write(id_offset);
+	for(const auto &feature : features)
+		writer.write(id_offset += feature.get_id().size());
+	for(const auto &feature : features)
+		writer.write_string(feature.get_id());
+}
+
+void zoning_process_impl::save_border(zoning_checkpoint_writer &writer) {
+	writer.begin_section(zoning_checkpoint_format::border_tag);
+	writer.write(uint64_t(border.size()));
+	write_vertices(writer, border);
+}
+
+/**
+ * The geometries are saved sorted by zone id, as the vertex offsets of each geometry and the array of the vertex
+ * coordinates rounded to doubles. The neighbors and the fusion of the zones depend on the exact equality of the
+ * vertices of neighbor geometries: the coordinates which are not doubles are saved exactly, as the doubles summing to
+ * their numerator and to their denominator, whose counts are saved for each coordinate (none for the doubles), then
+ * the doubles of all the coordinates. The geometries are not saved when a coordinate can not be split into doubles.
+ */
+void zoning_process_impl::save_geometries(zoning_checkpoint_writer &writer) {
+	const auto &voronoi_zones = get_voronoi_map().get_zones();
+	std::vector<uint64_t> vertex_offsets(1, 0);
+	std::vector<double> coordinates;
+	std::vector<uint8_t> term_sizes;
+	std::vector<double> terms;
+	for(const auto &voronoi_zone : voronoi_zones) {
+		polygon_type geometry = voronoi_zone.get_geometry();
+		vertex_offsets.push_back(vertex_offsets.back() + geometry.size());
+		for(auto vertex = geometry.vertices_begin(); vertex != geometry.vertices_end(); ++vertex) {
+			for(const kernel_type::FT &coordinate : { vertex->x(), vertex->y() }) {
+				coordinates.push_back(CGAL::to_double(coordinate));
+				if(kernel_type::FT(coordinates.back()) == coordinate) {
+					term_sizes.insert(term_sizes.end(), 2, 0);
+					continue;
+				}
+				exact_numerator_type numerator, denominator;
+				exact_fraction_traits::Decompose()(CGAL::exact(coordinate), numerator, denominator);
+				if(!scale_exact_fraction(numerator, denominator))
+					return;
+				for(const exact_numerator_type &value : { numerator, denominator }) {
+					size_t term_offset = terms.size();
+					if(!split_exact_terms(value, terms))
+						return;
+					term_sizes.push_back(uint8_t(terms.size() - term_offset));
+				}
+			}
+		}
+	}
+	writer.begin_section(zoning_checkpoint_format::cell_tag);
+	writer.write(uint64_t(boost::size(voronoi_zones)));
+	writer.write(uint64_t(terms.size()));
+	writer.write_range(vertex_offsets);
+	writer.write_range(coordinates);
+	writer.write_range(term_sizes);
+	writer.align();
+	writer.write_range(terms);
+}
+
+/**
+ * The neighbors are saved as sorted pairs of zone indices, the zones being indexed sorted by id. The order of the
+ * neighbors follows the triangulation, which depends on the random shuffle of its construction.
+ */
+void zoning_process_impl::save_neighbors(zoning_checkpoint_writer &writer) {
+	auto write_zone_neighbors = [this, &writer](const_zone_neighbor_range_type zone_neighbors) {
+		for(const auto &zone_index_pair : get_zone_index_pairs(zone_neighbors)) {
+			writer.write(zone_index_pair.first);
+			writer.write(zone_index_pair.second);
+		}
+	};
+	writer.begin_section(zoning_checkpoint_format::neighbor_tag);
+	writer.write(uint64_t(boost::size(get_zone_neighbors())));
+	writer.write(uint64_t(boost::size(get_filtered_zone_neighbors())));
+	write_zone_neighbors(get_zone_neighbors());
+	write_zone_neighbors(get_filtered_zone_neighbors());
+}
+
+/**
+ * Returns the neighbors as sorted pairs of zone indices, the zones being indexed sorted by id.
+ */
+zoning_process_impl::zone_index_pair_container_type zoning_process_impl::get_zone_index_pairs(const_zone_neighbor_range_type zone_neighbors) {
+	std::unordered_map<const zone_type *, uint32_t> zone_indices;
+	for(const zone_type &zone : _voronoi_process.get_zones())
+		zone_indices.emplace(&zone, zone_indices.size());
+	zone_index_pair_container_type zone_index_pairs;
+	zone_index_pairs.reserve(boost::size(zone_neighbors));
+	for(const auto &zone_neighbor : zone_neighbors) {
+		uint32_t zone_index1 = zone_indices.at(&zone_neighbor.get_zone1());
+		uint32_t zone_index2 = zone_indices.at(&zone_neighbor.get_zone2());
+		zone_index_pairs.push_back(std::minmax(zone_index1, zone_index2));
+	}
+	std::sort(zone_index_pairs.begin(), zone_index_pairs.end());
+	return zone_index_pairs;
+}
+
+void zoning_process_impl::save_fusion_steps(zoning_checkpoint_writer &writer) {
+	zone_fusion_step_container_type zone_fusion_steps = _fusion_process.get_fusion_steps(_voronoi_process.get_zones());
+	writer.begin_section(zoning_checkpoint_format::fusion_tag);
+	writer.write(uint64_t(zone_fusion_steps.size()));
+	for(const zone_fusion_step &zone_fusion_step : zone_fusion_steps) {
+		writer.write(uint32_t(zone_fusion_step.zone1));
+		writer.write(uint32_t(zone_fusion_step.zone2));
+		writer.write(zone_fusion_step.distance);
+	}
+}
+
+zoning_process_impl::polygon_container_type zoning_process_impl::load_geometries(zoning_checkpoint_section section) const {
+	typedef zoning_process_traits::point_type point_type;
+
+	uint64_t geometry_size = section.read<uint64_t>();
+	uint64_t term_size = section.read<uint64_t>();
+	if(geometry_size != get_site_feature_size())
+		throw zoning_checkpoint_error("geometries do not match the zoning");
+	std::vector<uint64_t> vertex_offsets = section.read_vector<uint64_t>(geometry_size + 1);
+	if(vertex_offsets.front() != 0 || !std::is_sorted(vertex_offsets.begin(), vertex_offsets.end()) || vertex_offsets.back() > std::numeric_limits<uint32_t>::max())
+		throw zoning_checkpoint_error("corrupted geometries");
+	std::vector<double> coordinates = section.read_vector<double>(2 * vertex_offsets.back());
+	std::vector<uint8_t> term_sizes = section.read_vector<uint8_t>(2 * coordinates.size());
+	section.align();
+	std::vector<double> terms = section.read_vector<double>(term_size);
+	if(std::accumulate(term_sizes.begin(), term_sizes.end(), uint64_t(0)) != term_size)
+		throw zoning_checkpoint_error("corrupted geometries");
+	const double *term = terms.data();
+	auto read_coordinate = [&](uint64_t coordinate_index) {
+		uint8_t numerator_size = term_sizes[2 * coordinate_index], denominator_size = term_sizes[2 * coordinate_index + 1];
+		if(numerator_size == 0 && denominator_size == 0)
+			return kernel_type::FT(coordinates[coordinate_index]);
+		exact_numerator_type numerator = sum_exact_terms(term, numerator_size);
+		exact_numerator_type denominator = sum_exact_terms(term + numerator_size, denominator_size);
+		term += numerator_size + denominator_size;
+		if(CGAL::is_zero(denominator))
+			throw zoning_checkpoint_error("corrupted geometries");
+		return kernel_type::FT(exact_fraction_traits::Compose()(numerator, denominator));
+	};
+	polygon_container_type geometries;
+	geometries.reserve(geometry_size);
+	for(size_t geometry_index = 0; geometry_index < geometry_size; ++geometry_index) {
+		polygon_type geometry;
+		for(uint64_t vertex_index = vertex_offsets[geometry_index]; vertex_index < vertex_offsets[geometry_index + 1]; ++vertex_index) {
+			kernel_type::FT x = read_coordinate(2 * vertex_index);
+			kernel_type::FT y = read_coordinate(2 * vertex_index + 1);
+			geometry.push_back(point_type(x, y));
+		}
+		geometries.push_back(geometry);
+	}
+	return geometries;
+}
+
+zoning_process_impl::zone_fusion_step_container_type zoning_process_impl::load_fusion_steps(zoning_checkpoint_section section) const {
+	uint64_t zone_size = get_site_feature_size();
+	uint64_t zone_fusion_step_size = section.read<uint64_t>();
+	if(zone_fusion_step_size >= std::max<uint64_t>(zone_size, 1))
+		throw zoning_checkpoint_error("corrupted fusion");
+	zone_fusion_step_container_type zone_fusion_steps;
+	zone_fusion_steps.reserve(zone_fusion_step_size);
+	for(uint64_t zone_fusion_step_index = 0; zone_fusion_step_index < zone_fusion_step_size; ++zone_fusion_step_index) {
+		uint32_t zone1 = section.read<uint32_t>();
+		uint32_t zone2 = section.read<uint32_t>();
+		double distance = section.read<double>();
+		if(zone1 == zone2 || zone1 >= zone_size + zone_fusion_step_index || zone2 >= zone_size + zone_fusion_step_index)
+			throw zoning_checkpoint_error("corrupted fusion");
+		zone_fusion_steps.push_back(zone_fusion_step(zone1, zone2, distance));
+	}
+	return zone_fusion_steps;
 }
 
 } // namespace geofis
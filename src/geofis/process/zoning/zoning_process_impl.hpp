@@ -39,54 +39,105 @@
 #ifndef HE398EA57_9602_4906_A051_BAF8095DD924
 #define HE398EA57_9602_4906_A051_BAF8095DD924
 
+#include <iosfwd>
+#include <vector>
+#include <utility>
+#include <cstdint>
 #include <geofis/process/zoning/zoning_process_traits.hpp>
 #include <geofis/process/zoning/voronoi/voronoi_process.hpp>
 #include <geofis/process/zoning/neighborhood/neighborhood_process.hpp>
 #include <geofis/process/zoning/fusion/fusion_process.hpp>
+#include <geofis/process/zoning/spanning_tree/spanning_tree_process.hpp>
 #include <geofis/process/zoning/merge/merge_process.hpp>
+#include <geofis/process/zoning/zoning_checkpoint.hpp>
+#include <util/cache/lru_cache.hpp>
 
 namespace geofis {
 
 class zoning_process_impl {
 
+	typedef zoning_process_traits::kernel_type kernel_type;
 	typedef zoning_process_traits::polygon_type polygon_type;
+	typedef zoning_process_traits::polygon_container_type polygon_container_type;
 	typedef zoning_process_traits::feature_container_type feature_container_type;
 	typedef zoning_process_traits::feature_range_type feature_range_type;
+	typedef zoning_process_traits::feature_binning_type feature_binning_type;
+	typedef zoning_process_traits::feature_bin_type feature_bin_type;
+	typedef zoning_process_traits::feature_bin_container_type feature_bin_container_type;
 	typedef zoning_process_traits::voronoi_map_type voronoi_map_type;
+	typedef zoning_process_traits::voronoi_construction_type voronoi_construction_type;
 	typedef zoning_process_traits::neighborhood_type neighborhood_type;
 	typedef zoning_process_traits::const_zone_neighbor_range_type const_zone_neighbor_range_type;
 	typedef voronoi_process voronoi_process_type;
 	typedef neighborhood_process neighborhood_process_type;
 	typedef zoning_process_traits::aggregation_type aggregation_type;
+	typedef zoning_process_traits::fusion_strategy_type fusion_strategy_type;
 	typedef zoning_process_traits::zone_distance_type zone_distance_type;
 	typedef zoning_process_traits::multidimensional_distance_type multidimensional_distance_type;
 	typedef zoning_process_traits::attribute_distance_type attribute_distance_type;
 	typedef zoning_process_traits::attribute_distance_container_type attribute_distance_container_type;
 	typedef fusion_process fusion_process_type;
+	typedef spanning_tree_process spanning_tree_process_type;
 	typedef zoning_process_traits::fusion_map_type fusion_map_type;
 	typedef zoning_process_traits::fusion_map_range_type fusion_map_range_type;
+	typedef zoning_process_traits::zone_fusion_step_container_type zone_fusion_step_container_type;
+	typedef zoning_process_traits::zone_fusion_step_container_list_type zone_fusion_step_container_list_type;
+	typedef zoning_process_traits::fusion_configuration_type fusion_configuration_type;
+	typedef zoning_process_traits::fusion_configuration_container_type fusion_configuration_container_type;
+	typedef zoning_process_traits::zoning_quality_container_type zoning_quality_container_type;
+	typedef zoning_process_traits::zone_info_policy_type zone_info_policy_type;
+	typedef zoning_process_traits::zone_type zone_type;
+	typedef zoning_process_traits::zone_neighbor_range_type zone_neighbor_range_type;
 	typedef zoning_process_traits::merge_type merge_type;
 	typedef zoning_process_traits::merge_map_type merge_map_type;
+	typedef zoning_process_traits::zone_geometry_cache_type zone_geometry_cache_type;
+	typedef zoning_process_traits::point_container_type point_container_type;
+	typedef zoning_process_traits::zone_label_container_type zone_label_container_type;
+	typedef zoning_process_traits::raster_grid_type raster_grid_type;
+	typedef zoning_process_traits::raster_label_container_type raster_label_container_type;
+	typedef zoning_process_traits::progress_callback_type progress_callback_type;
+	typedef zoning_process_traits::cancellation_token_type cancellation_token_type;
+	typedef zoning_process_traits::progress_monitor_type progress_monitor_type;
 	typedef merge_process merge_process_type;
+	typedef std::vector<std::pair<uint32_t, uint32_t>> zone_index_pair_container_type;
+
+	static const size_t default_stage_cache_capacity = 4;
+	static const size_t default_zone_geometry_cache_budget = size_t(64) << 20;
 
 	polygon_type border;
 	feature_container_type features;
 	feature_range_type unique_features;
 	feature_range_type bounded_features;
+	feature_binning_type feature_binning;
+	feature_container_type binned_features;
+	std::vector<size_t> feature_bins;
+	std::vector<size_t> bin_sizes;
+	feature_range_type site_features;
+	voronoi_construction_type voronoi_construction;
+	size_t voronoi_tile_count;
 	voronoi_process_type _voronoi_process;
 	neighborhood_type neighborhood;
 	neighborhood_process_type _neighborhood_process;
 	aggregation_type aggregation;
+	fusion_strategy_type fusion_strategy;
 	zone_distance_type zone_distance;
 	multidimensional_distance_type multidimensional_distance;
 	attribute_distance_container_type attribute_distances;
 	fusion_process_type _fusion_process;
 	merge_type merge;
 	merge_process_type _merge_process;
+	mutable progress_monitor_type progress;
+	uint64_t bounded_feature_key;
+	uint64_t voronoi_key;
+	uint64_t zone_neighbor_key;
+	util::lru_cache<uint64_t, polygon_container_type> voronoi_cache;
+	util::lru_cache<uint64_t, zone_fusion_step_container_type> fusion_cache;
+	mutable zone_geometry_cache_type geometry_cache;
 
 public:
 	zoning_process_impl(const feature_container_type &features);
-	template <class FeatureRange> zoning_process_impl(const FeatureRange &features) : features(boost::begin(features), boost::end(features)) {
+	zoning_process_impl(feature_container_type &&features);
+	template <class FeatureRange> zoning_process_impl(const FeatureRange &features) : features(boost::begin(features), boost::end(features)), voronoi_tile_count(0), bounded_feature_key(0), voronoi_key(0), zone_neighbor_key(0), voronoi_cache(default_stage_cache_capacity), fusion_cache(default_stage_cache_capacity), geometry_cache(default_zone_geometry_cache_budget) {
 		initialize_features();
 	}
 
@@ -94,6 +145,9 @@ public:
 
 	void set_border(const polygon_type &border);
 	polygon_type get_border() const;
+	void set_feature_binning(const feature_binning_type &feature_binning);
+	void set_voronoi_construction(const voronoi_construction_type &voronoi_construction);
+	void set_voronoi_tile_count(size_t voronoi_tile_count);
 	void compute_voronoi_process();
 	void release_voronoi_process();
 	bool is_voronoi_implemented() const;
@@ -101,6 +155,8 @@ public:
 
 	size_t get_unique_feature_size() const;
 	size_t get_bounded_feature_size() const;
+	size_t get_site_feature_size() const;
+	feature_bin_container_type get_feature_bins() const;
 
 	void set_neighborhood(const neighborhood_type &neighborhood);
 	void compute_neighborhood_process();
@@ -110,6 +166,7 @@ public:
 	const_zone_neighbor_range_type get_filtered_zone_neighbors() const;
 
 	void set_aggregation(const aggregation_type &aggregation);
+	void set_fusion_strategy(const fusion_strategy_type &fusion_strategy);
 	void set_zone_distance(const zone_distance_type &zone_distance);
 	void set_multidimensional_distance(const multidimensional_distance_type &multidimensional_distance);
 	void set_attribute_distances(const attribute_distance_container_type &attribute_distances);
@@ -117,7 +174,13 @@ public:
 	void release_fusion_process();
 	bool is_fusion_implemented() const;
 	size_t get_fusion_size() const;
+	size_t get_cut_zone_size(double distance) const;
 	fusion_map_range_type get_fusion_maps(size_t begin, size_t end, bool compute_zones);
+	zone_fusion_step_container_list_type compute_fusion_sweep(const fusion_configuration_container_type &fusion_configurations, size_t thread_count);
+	void restore_fusion_process(const zone_fusion_step_container_type &zone_fusion_steps);
+	zoning_quality_container_type get_fusion_qualities();
+	std::vector<std::string> get_fusion_leaf_ids();
+	void get_fusion_dendrogram(int *merges, double *heights, int *order);
 
 	void set_merge(const merge_type &merge);
 	merge_type get_merge() const;
@@ -126,9 +189,43 @@ public:
 	bool is_merge_implemented() const;
 	size_t get_merge_size() const;
 	merge_map_type get_merge_map(size_t map_index) const;
+	merge_map_type get_merge_map(size_t map_index, double tolerance) const;
+	zone_label_container_type get_merge_map_labels(const point_container_type &points, const std::vector<size_t> &map_indices) const;
+	raster_grid_type get_raster_grid(double cell_size) const;
+	raster_label_container_type get_merge_map_rasters(const raster_grid_type &grid, const std::vector<size_t> &map_indices) const;
+	zoning_quality_container_type get_merge_qualities(const std::vector<size_t> &map_indices) const;
+
+	void set_progress(const progress_callback_type &callback, const cancellation_token_type &cancellation_token);
+	void set_stage_cache_capacity(size_t capacity);
+	void set_zone_geometry_cache_budget(size_t budget);
+	const zone_geometry_cache_type &get_zone_geometry_cache() const;
+
+	void save(std::ostream &stream, bool save_geometries);
+	void load(std::istream &stream);
 
 private:
 	void initialize_features();
+	void initialize_bounded_feature_key();
+	void initialize_site_features();
+	void initialize_site_labels(size_t map_index, std::vector<size_t> &site_labels) const;
+	std::vector<zone_moments> get_site_moments() const;
+	zone_moments get_zone_moments(const std::vector<zone_moments> &site_moments, const zone_type &zone) const;
+	uint64_t get_voronoi_key() const;
+	uint64_t get_fusion_key(const aggregation_type &aggregation, const zone_distance_type &zone_distance, const multidimensional_distance_type &multidimensional_distance, const attribute_distance_container_type &attribute_distances) const;
+	polygon_container_type get_voronoi_geometries() const;
+	zone_index_pair_container_type get_zone_index_pairs(const_zone_neighbor_range_type zone_neighbors);
+	void restore_voronoi_process(const polygon_container_type &geometries);
+
+	void save_configuration(zoning_checkpoint_writer &writer);
+	void save_features(zoning_checkpoint_writer &writer);
+	void save_border(zoning_checkpoint_writer &writer);
+	void save_geometries(zoning_checkpoint_writer &writer);
+	void save_neighbors(zoning_checkpoint_writer &writer);
+	void save_fusion_steps(zoning_checkpoint_writer &writer);
+	void check_section(const zoning_checkpoint_reader &reader, uint32_t tag, void (zoning_process_impl::*save_section)(zoning_checkpoint_writer &), const std::string &name);
+	polygon_container_type load_geometries(zoning_checkpoint_section section) const;
+	zone_fusion_step_container_type load_fusion_steps(zoning_checkpoint_section section) const;
+	void restore_stages(const zoning_checkpoint_reader &reader, const polygon_container_type &geometries, const zone_fusion_step_container_type &zone_fusion_steps);
 };
 
 } // namespace geofis
@@ -41,26 +41,36 @@
 
 #include <string>
 #include <vector>
-#include <list>
+#include <deque>
 #include <boost/range.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <util/progress/progress_monitor.hpp>
 #include <geofis/data/feature.hpp>
+#include <geofis/algorithm/feature/binning/feature_binning.hpp>
+#include <geofis/algorithm/feature/binning/variant_feature_binning.hpp>
 #include <geofis/algorithm/zoning/geometry/zoning_geometry_traits.hpp>
 #include <geofis/algorithm/zoning/fusion/zone/zone.hpp>
 #include <geofis/algorithm/zoning/fusion/voronoi/zone_info.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_zone.hpp>
 #include <geofis/algorithm/zoning/triangulation/voronoi/voronoi_map.hpp>
+#include <geofis/algorithm/zoning/triangulation/voronoi/variant_voronoi_construction.hpp>
 #include <geofis/algorithm/zoning/neighborhood/variant_neighborhood.hpp>
 #include <geofis/algorithm/zoning/neighborhood/zone_neighbor.hpp>
 #include <geofis/algorithm/zoning/fusion/aggregation/variant_aggregation.hpp>
+#include <geofis/algorithm/zoning/fusion/strategy/variant_fusion_strategy.hpp>
 #include <geofis/algorithm/zoning/fusion/distance/variant_zone_distance.hpp>
 #include <geofis/algorithm/zoning/fusion/distance/variant_multidimensional_distance.hpp>
 #include <geofis/algorithm/zoning/fusion/distance/variant_attribute_distance.hpp>
 #include <geofis/algorithm/zoning/fusion/distance/variant_feature_distance.hpp>
 #include <geofis/algorithm/zoning/fusion/zone_fusion.hpp>
+#include <geofis/algorithm/zoning/fusion/zone_fusion_step.hpp>
+#include <geofis/algorithm/zoning/fusion/fusion_configuration.hpp>
+#include <geofis/algorithm/zoning/fusion/zoning_quality.hpp>
 #include <geofis/algorithm/zoning/fusion/map/fusion_map_range.hpp>
 #include <geofis/algorithm/zoning/merge/variant_merge.hpp>
 #include <geofis/algorithm/zoning/map/map.hpp>
+#include <geofis/algorithm/zoning/map/zone_geometry_cache.hpp>
+#include <geofis/algorithm/zoning/map/raster_grid.hpp>
 
 namespace geofis {
 
@@ -70,10 +80,14 @@ struct zoning_process_traits {
 	typedef zoning_geometry_traits::point_type point_type;
 	typedef zoning_geometry_traits::polygon_type polygon_type;
 	typedef zoning_geometry_traits::polygon_with_holes_type polygon_with_holes_type;
+	typedef std::vector<polygon_type> polygon_container_type;
 
 	typedef feature<std::string, point_type, std::vector<double> > feature_type;
 	typedef std::vector<feature_type> feature_container_type;
 	typedef boost::sub_range<feature_container_type> feature_range_type;
+	typedef variant_feature_binning feature_binning_type;
+	typedef feature_bin<std::string> feature_bin_type;
+	typedef std::vector<feature_bin_type> feature_bin_container_type;
 
 	typedef voronoi_zone<polygon_type, feature_type> voronoi_zone_type;
 
@@ -83,6 +97,7 @@ struct zoning_process_traits {
 
 	typedef voronoi_map<kernel_type, feature_type, zone_info_policy_type> voronoi_map_type;
 	typedef voronoi_map_type::finite_edge_range_type finite_edge_range_type;
+	typedef variant_voronoi_construction voronoi_construction_type;
 
 	typedef variant_neighborhood neighborhood_type;
 
@@ -93,6 +108,8 @@ struct zoning_process_traits {
 
 	typedef variant_aggregation aggregation_type;
 
+	typedef variant_fusion_strategy fusion_strategy_type;
+
 	typedef variant_zone_distance zone_distance_type;
 
 	typedef variant_multidimensional_distance multidimensional_distance_type;
@@ -106,12 +123,26 @@ struct zoning_process_traits {
 
 	typedef zone_fusion<zone_type> zone_fusion_type;
 	typedef typename fusion_map_traits<zone_type>::fusion_map_type fusion_map_type;
-	typedef std::list<zone_fusion_type> zone_fusion_container_type;
+	typedef std::deque<zone_fusion_type> zone_fusion_container_type;
+	typedef std::vector<zone_fusion_step> zone_fusion_step_container_type;
+	typedef std::vector<zone_fusion_step_container_type> zone_fusion_step_container_list_type;
+	typedef fusion_configuration<aggregation_type, zone_distance_type, multidimensional_distance_type, attribute_distance_container_type> fusion_configuration_type;
+	typedef std::vector<fusion_configuration_type> fusion_configuration_container_type;
 	typedef typename fusion_map_range_traits<zone_fusion_container_type>::fusion_map_range_type fusion_map_range_type;
 	typedef typename boost::reversed_range<const fusion_map_range_type> reverse_fusion_map_range_type;
+	typedef std::vector<zoning_quality> zoning_quality_container_type;
 
 	typedef variant_merge merge_type;
 	typedef map<zone_type> merge_map_type;
+	typedef zone_geometry_cache<zone_type> zone_geometry_cache_type;
+	typedef std::vector<point_type> point_container_type;
+	typedef std::vector<size_t> zone_label_container_type;
+	typedef raster_grid raster_grid_type;
+	typedef std::vector<uint32_t> raster_label_container_type;
+
+	typedef util::progress_monitor progress_monitor_type;
+	typedef progress_monitor_type::callback_type progress_callback_type;
+	typedef progress_monitor_type::cancellation_token_type cancellation_token_type;
 };
 
 } // namespace geofis
@@ -0,0 +1,139 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef H0B050006_BD6C_48E6_8CC3_B9309CA177B6
+#define H0B050006_BD6C_48E6_8CC3_B9309CA177B6
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <geofis/process/zoning/zoning_process.hpp>
+
+namespace geofis {
+
+/**
+ * The last progress reported by a zoning task.
+ */
+struct zoning_task_progress {
+
+	zoning_task_progress() : fraction(0), throughput(0) {}
+
+	std::string stage;
+	double fraction;
+	double throughput;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Runs stages of a zoning process on a background thread.
+ *
+ * The progress of the process is redirected to the task while it runs: the reported progress is stored to be polled
+ * from another thread and the cancellation token is set by cancel. The process must not be used before the task is
+ * done, its progress is then reset and must be set again by the caller.
+ */
+class zoning_task : public boost::noncopyable {
+
+	typedef zoning_process_traits::progress_callback_type progress_callback_type;
+	typedef zoning_process_traits::cancellation_token_type cancellation_token_type;
+
+public:
+	template <class Function> zoning_task(zoning_process &process, const Function &function) : process(process), cancelled(false) {
+		process.set_progress([this](const std::string &stage, double fraction, double throughput) { report(stage, fraction, throughput); }, [this]() { return cancelled.load(); });
+		try {
+			result = std::async(std::launch::async, [&process, function]() { function(process); });
+		} catch(...) {
+			process.set_progress(progress_callback_type(), cancellation_token_type());
+			throw;
+		}
+	}
+
+	~zoning_task() {
+		if(result.valid()) {
+			cancel();
+			result.wait();
+		}
+		process.set_progress(progress_callback_type(), cancellation_token_type());
+	}
+
+	bool is_done() const {
+		return wait_for(std::chrono::milliseconds(0));
+	}
+
+	template <class Rep, class Period> bool wait_for(const std::chrono::duration<Rep, Period> &duration) const {
+		return !result.valid() || result.wait_for(duration) == std::future_status::ready;
+	}
+
+	void cancel() {
+		cancelled = true;
+	}
+
+	zoning_task_progress get_progress() const {
+		std::lock_guard<std::mutex> lock(progress_mutex);
+		return progress;
+	}
+
+	/**
+	 * Waits for the end of the task and rethrows the exception thrown by the stages.
+	 */
+	void get() {
+		if(result.valid())
+			result.get();
+	}
+
+private:
+	zoning_process &process;
+	std::future<void> result;
+	std::atomic<bool> cancelled;
+	mutable std::mutex progress_mutex;
+	zoning_task_progress progress;
+
+	void report(const std::string &stage, double fraction, double throughput) {
+		std::lock_guard<std::mutex> lock(progress_mutex);
+		progress.stage = stage;
+		progress.fraction = fraction;
+		progress.throughput = throughput;
+	}
+};
+
+} // namespace geofis
+
+#endif // H0B050006_BD6C_48E6_8CC3_B9309CA177B6
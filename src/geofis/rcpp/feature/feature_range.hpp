@@ -40,16 +40,69 @@
 #define HB8703697_4B80_4020_A218_2A6CAFE2A27C
 
 #include <Rcpp.h>
-#include <boost/range/combine.hpp>
-#include <boost/range/adaptor/transformed.hpp>
-#include <rcpp/vector_range.hpp>
-#include <rcpp/matrix_range.hpp>
-#include <geofis/rcpp/feature/feature_maker.hpp>
+#include <string>
+#include <vector>
+#include <utility>
 
 namespace geofis {
 
-template <class Feature> inline auto make_rcpp_feature_range(const Rcpp::StringVector &ids, const Rcpp::NumericMatrix &points, const Rcpp::NumericMatrix &data) {
-	return boost::combine(Rcpp::make_vector_range(ids), Rcpp::make_row_range(points), Rcpp::make_row_range(data)) | boost::adaptors::transformed(rcpp_feature_maker<Feature>());
+/**
+ * Numeric columns of a data frame, read in place: a double column is not copied, an integer column is converted once.
+ */
+inline std::vector<Rcpp::NumericVector> make_rcpp_numeric_columns(const Rcpp::DataFrame &data_frame) {
+	std::vector<Rcpp::NumericVector> columns;
+	columns.reserve(data_frame.size());
+	for(R_xlen_t index = 0; index < data_frame.size(); ++index)
+		columns.push_back(Rcpp::NumericVector(VECTOR_ELT(data_frame, index)));
+	return columns;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Row names of a data frame, without the character conversion of the R rownames function for the automatic row names.
+ */
+class rcpp_row_names {
+
+public:
+	rcpp_row_names(const Rcpp::DataFrame &data_frame) : row_names(Rf_getAttrib(data_frame, R_RowNamesSymbol)) {}
+
+	std::string operator[](R_xlen_t index) const {
+		if(TYPEOF(row_names) == STRSXP)
+			return std::string(CHAR(STRING_ELT(row_names, index)));
+		else
+			return std::to_string(INTEGER(row_names)[index]);
+	}
+
+private:
+	Rcpp::RObject row_names;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Makes the features of a SpatialPointsDataFrame in one pass from its coordinates matrix and its data frame columns,
+ * each feature attributes being allocated once from the row values of the columns.
+ */
+template <class Feature> inline std::vector<Feature> make_rcpp_features(const Rcpp::NumericMatrix &points, const Rcpp::DataFrame &data_frame) {
+
+	typedef typename Feature::geometry_type geometry_type;
+	typedef typename Feature::attribute_range_type attribute_range_type;
+
+	std::vector<Rcpp::NumericVector> columns = make_rcpp_numeric_columns(data_frame);
+	rcpp_row_names row_names(data_frame);
+	R_xlen_t size = points.nrow();
+	const double *x = points.begin();
+	const double *y = x + size;
+	std::vector<Feature> features;
+	features.reserve(size);
+	for(R_xlen_t row = 0; row < size; ++row) {
+		attribute_range_type attributes(columns.size());
+		for(size_t column = 0; column < columns.size(); ++column)
+			attributes[column] = columns[column][row];
+		features.push_back(Feature(row_names[row], geometry_type(x[row], y[row]), std::move(attributes)));
+	}
+	return features;
 }
 
 } // namespace geofis
@@ -0,0 +1,179 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef H5C1E7A42_3B8D_4F0A_9E26_7D4B1C8F2A61
+#define H5C1E7A42_3B8D_4F0A_9E26_7D4B1C8F2A61
+
+#include <Rcpp.h>
+#include <limits>
+#include <string>
+#include <algorithm>
+#include <CGAL/Point_2.h>
+#include <CGAL/Polygon_2.h>
+#include <CGAL/Polygon_with_holes_2.h>
+
+namespace geofis {
+
+/**
+ * Bounding box of the simple feature geometries, extended by each converted coordinate.
+ */
+struct sfc_bbox {
+
+	sfc_bbox() : xmin(std::numeric_limits<double>::infinity()), ymin(xmin), xmax(-xmin), ymax(-xmin) {}
+
+	void extend(double x, double y) {
+		xmin = std::min(xmin, x);
+		ymin = std::min(ymin, y);
+		xmax = std::max(xmax, x);
+		ymax = std::max(ymax, y);
+	}
+
+	double xmin;
+	double ymin;
+	double xmax;
+	double ymax;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Makes the closed ring of a polygon as the coordinate matrix of a simple feature, the coordinates being converted
+ * from the kernel number type in one pass.
+ */
+template <class Kernel> Rcpp::NumericMatrix make_sf_ring(const CGAL::Polygon_2<Kernel> &polygon, sfc_bbox &bbox) {
+	size_t size = polygon.size();
+	Rcpp::NumericMatrix coords(size + 1, 2);
+	double *x = coords.begin();
+	double *y = x + size + 1;
+	size_t index = 0;
+	for(auto vertex = polygon.vertices_begin(); vertex != polygon.vertices_end(); ++vertex, ++index) {
+		x[index] = CGAL::to_double(vertex->x());
+		y[index] = CGAL::to_double(vertex->y());
+		bbox.extend(x[index], y[index]);
+	}
+	x[size] = x[0];
+	y[size] = y[0];
+	return coords;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline void set_sfg_class(SEXP sfg, const char *type) {
+	Rf_setAttrib(sfg, R_ClassSymbol, Rcpp::CharacterVector::create("XY", type, "sfg"));
+}
+
+template <class Kernel> Rcpp::List make_sfg_polygon(const CGAL::Polygon_2<Kernel> &polygon, sfc_bbox &bbox) {
+	Rcpp::List rings(1);
+	rings[0] = make_sf_ring(polygon, bbox);
+	set_sfg_class(rings, "POLYGON");
+	return rings;
+}
+
+template <class Kernel> Rcpp::List make_sfg_polygon(const CGAL::Polygon_with_holes_2<Kernel> &polygon_with_holes, sfc_bbox &bbox) {
+	Rcpp::List rings(polygon_with_holes.number_of_holes() + 1);
+	rings[0] = make_sf_ring(polygon_with_holes.outer_boundary(), bbox);
+	R_xlen_t index = 1;
+	for(auto hole = polygon_with_holes.holes_begin(); hole != polygon_with_holes.holes_end(); ++hole)
+		rings[index++] = make_sf_ring(*hole, bbox);
+	set_sfg_class(rings, "POLYGON");
+	return rings;
+}
+
+template <class Kernel> Rcpp::NumericMatrix make_sfg_linestring(const CGAL::Point_2<Kernel> &point1, const CGAL::Point_2<Kernel> &point2, sfc_bbox &bbox) {
+	Rcpp::NumericMatrix coords(2, 2);
+	coords(0, 0) = CGAL::to_double(point1.x());
+	coords(1, 0) = CGAL::to_double(point2.x());
+	coords(0, 1) = CGAL::to_double(point1.y());
+	coords(1, 1) = CGAL::to_double(point2.y());
+	bbox.extend(coords(0, 0), coords(0, 1));
+	bbox.extend(coords(1, 0), coords(1, 1));
+	set_sfg_class(coords, "LINESTRING");
+	return coords;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Sets the attributes of a simple feature geometry column of the given type on a list of geometries: the class, the
+ * precision, the bounding box, the coordinate reference system (a sf crs object) and the number of empty geometries.
+ */
+inline Rcpp::List make_sfc(Rcpp::List geometries, const char *type, const sfc_bbox &bbox, const Rcpp::List &crs) {
+	std::string sfc_type = std::string("sfc_") + type;
+	geometries.attr("class") = Rcpp::CharacterVector::create(sfc_type, "sfc");
+	geometries.attr("precision") = 0.0;
+	Rcpp::NumericVector bbox_values = geometries.size() ? Rcpp::NumericVector::create(bbox.xmin, bbox.ymin, bbox.xmax, bbox.ymax) : Rcpp::NumericVector(4, NA_REAL);
+	bbox_values.attr("names") = Rcpp::CharacterVector::create("xmin", "ymin", "xmax", "ymax");
+	bbox_values.attr("class") = "bbox";
+	geometries.attr("bbox") = bbox_values;
+	geometries.attr("crs") = crs;
+	geometries.attr("n_empty") = 0;
+	return geometries;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Makes a sf data frame of the columns of data_frame and of the geometry column, the relations of the attributes to
+ * the geometries being unknown as set by st_sf.
+ */
+inline Rcpp::List make_sf(Rcpp::List data_frame, const Rcpp::List &geometry) {
+	int column_size = data_frame.size();
+	Rcpp::List columns(column_size + 1);
+	Rcpp::CharacterVector names(column_size + 1);
+	Rcpp::CharacterVector data_names = data_frame.attr("names");
+	for(int column = 0; column < column_size; ++column) {
+		columns[column] = data_frame[column];
+		names[column] = data_names[column];
+	}
+	columns[column_size] = geometry;
+	names[column_size] = "geometry";
+	columns.attr("names") = names;
+	columns.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -int(geometry.size()));
+	columns.attr("class") = Rcpp::CharacterVector::create("sf", "data.frame");
+	columns.attr("sf_column") = "geometry";
+	Rcpp::IntegerVector agr(column_size, NA_INTEGER);
+	agr.attr("names") = data_names;
+	agr.attr("levels") = Rcpp::CharacterVector::create("constant", "aggregate", "identity");
+	agr.attr("class") = "factor";
+	columns.attr("agr") = agr;
+	return columns;
+}
+
+} // namespace geofis
+
+#endif // H5C1E7A42_3B8D_4F0A_9E26_7D4B1C8F2A61
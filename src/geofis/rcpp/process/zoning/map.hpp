@@ -45,6 +45,7 @@
 #include <boost/range/adaptor/transformed.hpp>
 #include <geofis/geometry/geometrical.hpp>
 #include <geofis/rcpp/geometry/polygons.hpp>
+#include <geofis/rcpp/geometry/sfc.hpp>
 
 namespace geofis {
 
@@ -108,6 +109,22 @@ struct rcpp_map_maker {
 	}
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct sf_map_maker {
+
+	typedef Rcpp::List result_type;
+
+	Rcpp::List crs;
+	Rcpp::CharacterVector col_names;
+
+	sf_map_maker(const Rcpp::List &crs, const Rcpp::CharacterVector &col_names) : crs(crs), col_names(col_names) {}
+
+	template <class Map> result_type operator() (const Map &map) const {
+		return make_sf_map(map, crs, col_names);
+	}
+};
+
 } // namespace detail
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -120,6 +137,21 @@ template <class Map> Rcpp::S4 make_rcpp_map(const Map &map, const Rcpp::S4 &crs,
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Makes the map as a sf data frame, the polygons of the zones being built in one pass without calling R functions.
+ */
+template <class Map> Rcpp::List make_sf_map(const Map &map, const Rcpp::List &crs, const Rcpp::CharacterVector &col_names) {
+	auto zone_range = map.get_zones();
+	Rcpp::List geometries(boost::size(zone_range));
+	sfc_bbox bbox;
+	R_xlen_t index = 0;
+	for(const auto &zone : zone_range)
+		geometries[index++] = make_sfg_polygon(zone.get_geometry(), bbox);
+	return make_sf(detail::make_rcpp_map_data_frame(map, col_names), make_sfc(geometries, "POLYGON", bbox, crs));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <class MapRange> Rcpp::List make_rcpp_map_list(const MapRange &map_range, const Rcpp::S4 &crs, const Rcpp::CharacterVector &col_names) {
@@ -127,6 +159,11 @@ template <class MapRange> Rcpp::List make_rcpp_map_list(const MapRange &map_rang
 	return Rcpp::List(boost::begin(rcpp_map_range), boost::end(rcpp_map_range));
 }
 
+template <class MapRange> Rcpp::List make_sf_map_list(const MapRange &map_range, const Rcpp::List &crs, const Rcpp::CharacterVector &col_names) {
+	auto sf_map_range = map_range | boost::adaptors::transformed(detail::sf_map_maker(crs, col_names));
+	return Rcpp::List(boost::begin(sf_map_range), boost::end(sf_map_range));
+}
+
 } // namespace geofis
 
 #endif // H39514393_1809_4FB0_937C_EAEF7B6602E5 
@@ -46,6 +46,7 @@
 #include <boost/range/adaptor/indexed.hpp>
 #include <boost/range/join.hpp>
 #include <geofis/rcpp/geometry/lines.hpp>
+#include <geofis/rcpp/geometry/sfc.hpp>
 
 namespace geofis {
 
@@ -96,6 +97,19 @@ template <class NeighborRange> Rcpp::S4 make_rcpp_neighborhood_map(const Neighbo
 	return spatial_lines_data_frame(Rcpp::Named("sl") = sl, Rcpp::Named("data") = data, Rcpp::Named("match.ID") = false);
 }
 
+/**
+ * Makes the neighborhood map as a sf data frame, the lines being built in one pass without calling R functions.
+ */
+template <class NeighborRange> Rcpp::List make_sf_neighborhood_map(const NeighborRange &neighbors, const NeighborRange &filtered_neighbors, const Rcpp::List &crs) {
+	Rcpp::List geometries(boost::distance(neighbors) + boost::distance(filtered_neighbors));
+	sfc_bbox bbox;
+	R_xlen_t index = 0;
+	for(const auto &neighbor : boost::join(neighbors, filtered_neighbors))
+		geometries[index++] = make_sfg_linestring(neighbor.get_zone1().get_feature(0).get_geometry(), neighbor.get_zone2().get_feature(0).get_geometry(), bbox);
+	Rcpp::DataFrame data = detail::make_rcpp_neighborhood_data_frame(neighbors, filtered_neighbors);
+	return make_sf(data, make_sfc(geometries, "LINESTRING", bbox, crs));
+}
+
 } // namespace geofis
 
 #endif // HD36A2CF8_32B9_40A4_87A2_8A0B4C619EC3
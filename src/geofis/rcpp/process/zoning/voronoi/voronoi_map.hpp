@@ -42,6 +42,7 @@
 #include <Rcpp.h>
 #include <geofis/geometry/geometrical.hpp>
 #include <geofis/rcpp/geometry/polygons.hpp>
+#include <geofis/rcpp/geometry/sfc.hpp>
 
 namespace geofis {
 
@@ -54,6 +55,19 @@ template <class VoronoiMap> Rcpp::S4 make_rcpp_voronoi_map(const VoronoiMap &vor
 	return spatial_polygons(Rcpp::Named("Srl") = Srl, Rcpp::Named("proj4string") = proj4string);
 }
 
+/**
+ * Makes the voronoi polygons as a sf geometry column, built in one pass without calling R functions.
+ */
+template <class VoronoiMap> Rcpp::List make_sf_voronoi_map(const VoronoiMap &voronoi_map, const Rcpp::List &crs) {
+	const auto &zones = voronoi_map.get_zones();
+	Rcpp::List geometries(boost::size(zones));
+	sfc_bbox bbox;
+	R_xlen_t index = 0;
+	for(const auto &zone : zones)
+		geometries[index++] = make_sfg_polygon(zone.get_geometry(), bbox);
+	return make_sfc(geometries, "POLYGON", bbox, crs);
+}
+
 } // namespace geofis
 
 #endif // H240DF543_434E_4E82_84FB_4330ED8B8AC5 
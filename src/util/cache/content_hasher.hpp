@@ -0,0 +1,91 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef CONTENT_HASHER_HPP_
+#define CONTENT_HASHER_HPP_
+
+#include <string>
+#include <cstdint>
+#include <type_traits>
+
+namespace util {
+
+/**
+ * Hashes a sequence of values from their bytes with the 64 bits FNV-1a function.
+ *
+ * Equal sequences of values have equal hashes, the values are written in a fixed order to address a content.
+ */
+class content_hasher {
+
+public:
+	content_hasher() : hash(offset_basis) {}
+
+	template <class T> void write(const T &value) {
+		static_assert(std::is_trivially_copyable<T>::value, "content hasher value must be trivially copyable");
+		write_bytes(reinterpret_cast<const unsigned char *>(&value), sizeof(T));
+	}
+
+	template <class Range> void write_range(const Range &values) {
+		for(const auto &value : values)
+			write(value);
+	}
+
+	void write_string(const std::string &value) {
+		write(uint64_t(value.size()));
+		write_bytes(reinterpret_cast<const unsigned char *>(value.data()), value.size());
+	}
+
+	uint64_t get_hash() const {
+		return hash;
+	}
+
+private:
+	static constexpr uint64_t offset_basis = 14695981039346656037ull;
+	static constexpr uint64_t prime = 1099511628211ull;
+
+	uint64_t hash;
+
+	void write_bytes(const unsigned char *bytes, size_t size) {
+		for(size_t index = 0; index < size; ++index)
+			hash = (hash ^ bytes[index]) * prime;
+	}
+};
+
+} // namespace util
+
+#endif /* CONTENT_HASHER_HPP_ */
@@ -0,0 +1,146 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef LRU_CACHE_HPP_
+#define LRU_CACHE_HPP_
+
+#include <list>
+#include <utility>
+#include <cstddef>
+#include <unordered_map>
+
+namespace util {
+
+/**
+ * Weighs each value as one, the capacity of the cache being a number of values.
+ */
+struct unit_weigher {
+
+	template <class Value> size_t operator()(const Value &) const {
+		return 1;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Keeps the values of the last used keys, up to a capacity.
+ *
+ * A found or inserted value becomes the most recently used one, the least recently used values are evicted when the
+ * sum of the value weights exceeds the capacity. A zero capacity disables the cache.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>, class Weigher = unit_weigher> class lru_cache {
+
+	typedef std::pair<Key, Value> entry_type;
+	typedef std::list<entry_type> entry_list_type;
+	typedef typename entry_list_type::iterator entry_iterator_type;
+
+public:
+	lru_cache(size_t capacity, const Weigher &weigher = Weigher()) : capacity(capacity), weight(0), weigher(weigher) {}
+
+	size_t get_capacity() const {
+		return capacity;
+	}
+
+	void set_capacity(size_t capacity) {
+		this->capacity = capacity;
+		evict();
+	}
+
+	size_t size() const {
+		return entries.size();
+	}
+
+	size_t get_weight() const {
+		return weight;
+	}
+
+	/**
+	 * Returns the value of the key, or null when the key is not cached. The pointer is valid until the next insert.
+	 */
+	const Value *find(const Key &key) {
+		auto entry = entry_iterators.find(key);
+		if(entry == entry_iterators.end())
+			return nullptr;
+		entries.splice(entries.begin(), entries, entry->second);
+		return &entry->second->second;
+	}
+
+	void insert(const Key &key, Value value) {
+		auto entry = entry_iterators.find(key);
+		if(entry != entry_iterators.end()) {
+			weight -= weigher(entry->second->second);
+			weight += weigher(value);
+			entry->second->second = std::move(value);
+			entries.splice(entries.begin(), entries, entry->second);
+			evict();
+			return;
+		}
+		if(capacity == 0)
+			return;
+		weight += weigher(value);
+		entries.emplace_front(key, std::move(value));
+		entry_iterators.emplace(key, entries.begin());
+		evict();
+	}
+
+	void clear() {
+		entry_iterators.clear();
+		entries.clear();
+		weight = 0;
+	}
+
+private:
+	size_t capacity;
+	size_t weight;
+	Weigher weigher;
+	entry_list_type entries;
+	std::unordered_map<Key, entry_iterator_type, Hash> entry_iterators;
+
+	void evict() {
+		while(weight > capacity) {
+			weight -= weigher(entries.back().second);
+			entry_iterators.erase(entries.back().first);
+			entries.pop_back();
+		}
+	}
+};
+
+} // namespace util
+
+#endif /* LRU_CACHE_HPP_ */
@@ -0,0 +1,259 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef FLATBUFFER_BUILDER_HPP_
+#define FLATBUFFER_BUILDER_HPP_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <boost/endian/conversion.hpp>
+#include <util/assert.hpp>
+
+namespace util {
+
+/**
+ * Fields of a flatbuffer table, the scalar fields being stored with their little endian bytes and the offset fields
+ * being patched once their target is written.
+ */
+class flatbuffer_table {
+
+	struct field {
+		uint16_t id;
+		uint8_t size;
+		uint8_t bytes[8];
+		size_t position;
+	};
+
+	std::vector<field> fields;
+
+	friend class flatbuffer_builder;
+
+public:
+	template <class T> void add_scalar(uint16_t id, T value) {
+		static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8, "flatbuffer scalar must be an arithmetic type");
+		field scalar_field = { id, uint8_t(sizeof(T)), {}, 0 };
+		store_little_endian(value, scalar_field.bytes);
+		fields.push_back(scalar_field);
+	}
+
+	void add_offset(uint16_t id) {
+		fields.push_back(field{ id, uint8_t(sizeof(uint32_t)), {}, 0 });
+	}
+
+	/**
+	 * Returns the position of a field in the buffer, once the table is written.
+	 */
+	size_t get_position(uint16_t id) const {
+		auto table_field = std::find_if(fields.begin(), fields.end(), [id](const field &table_field) { return table_field.id == id; });
+		UTIL_REQUIRE(table_field != fields.end());
+		return table_field->position;
+	}
+
+	template <class T> static void store_little_endian(T value, uint8_t *bytes) {
+		typedef typename std::conditional<sizeof(T) == 1, uint8_t, typename std::conditional<sizeof(T) == 2, uint16_t, typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type unsigned_type;
+		unsigned_type bits;
+		std::memcpy(&bits, &value, sizeof(T));
+		boost::endian::native_to_little_inplace(bits);
+		std::memcpy(bytes, &bits, sizeof(T));
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Writes a flatbuffer front to back: the buffer starts with the offset of the root table, and the vectors, strings
+ * and tables referred by a table are written after it, the offset fields being patched with the position of their
+ * target. Every offset points forward and the vtable of a table is written just before it, as allowed by the
+ * flatbuffers format.
+ *
+ * The values are aligned on their size from the start of the buffer, the buffer being read from an aligned memory
+ * block. The builder is cleared to write the next buffer without reallocation.
+ */
+class flatbuffer_builder {
+
+	std::vector<uint8_t> buffer;
+
+public:
+	void clear() {
+		buffer.clear();
+	}
+
+	const std::vector<uint8_t> &get_buffer() const {
+		return buffer;
+	}
+
+	size_t size() const {
+		return buffer.size();
+	}
+
+	/**
+	 * Starts the buffer with the offset of the root table, returns the position of the offset.
+	 */
+	size_t begin_root() {
+		UTIL_REQUIRE(buffer.empty());
+		return write_scalar(uint32_t(0));
+	}
+
+	/**
+	 * Writes the vtable and the inline fields of a table, the fields being placed by decreasing size so that they are
+	 * aligned, and returns the position of the table.
+	 */
+	size_t write_table(flatbuffer_table &table) {
+		std::vector<size_t> field_indices(table.fields.size());
+		for(size_t index = 0; index < field_indices.size(); ++index)
+			field_indices[index] = index;
+		std::stable_sort(field_indices.begin(), field_indices.end(), [&table](size_t index1, size_t index2) { return table.fields[index1].size > table.fields[index2].size; });
+		std::vector<uint16_t> field_offsets;
+		size_t table_size = sizeof(int32_t);
+		for(size_t index : field_indices) {
+			flatbuffer_table::field &table_field = table.fields[index];
+			table_size = align_size(table_size, table_field.size);
+			if(table_field.id >= field_offsets.size())
+				field_offsets.resize(table_field.id + 1, 0);
+			field_offsets[table_field.id] = uint16_t(table_size);
+			table_field.position = table_size;
+			table_size += table_field.size;
+		}
+		align(sizeof(uint16_t));
+		size_t vtable_position = buffer.size();
+		write_scalar(uint16_t(sizeof(uint16_t) * (field_offsets.size() + 2)));
+		write_scalar(uint16_t(table_size));
+		for(uint16_t field_offset : field_offsets)
+			write_scalar(field_offset);
+		align(sizeof(uint64_t));
+		size_t table_position = buffer.size();
+		buffer.resize(table_position + table_size, 0);
+		store(int32_t(table_position - vtable_position), table_position);
+		for(flatbuffer_table::field &table_field : table.fields) {
+			table_field.position += table_position;
+			std::memcpy(buffer.data() + table_field.position, table_field.bytes, table_field.size);
+		}
+		return table_position;
+	}
+
+	/**
+	 * Writes a vector of scalars, returns the position of its length.
+	 */
+	template <class T> size_t write_vector(const T *values, size_t size) {
+		align_vector(sizeof(T));
+		size_t vector_position = write_scalar(uint32_t(size));
+		for(size_t index = 0; index < size; ++index)
+			write_scalar(values[index]);
+		return vector_position;
+	}
+
+	template <class T> size_t write_vector(const std::vector<T> &values) {
+		return write_vector(values.data(), values.size());
+	}
+
+	/**
+	 * Writes a vector of offsets to patch, returns the position of its length, the offset of an element being at
+	 * get_offset_vector_element(position, index).
+	 */
+	size_t write_offset_vector(size_t size) {
+		align_vector(sizeof(uint32_t));
+		size_t vector_position = write_scalar(uint32_t(size));
+		buffer.resize(buffer.size() + size * sizeof(uint32_t), 0);
+		return vector_position;
+	}
+
+	static size_t get_offset_vector_element(size_t vector_position, size_t index) {
+		return vector_position + sizeof(uint32_t) * (index + 1);
+	}
+
+	/**
+	 * Writes a null terminated string, returns the position of its length.
+	 */
+	size_t write_string(const std::string &value) {
+		align(sizeof(uint32_t));
+		size_t string_position = write_scalar(uint32_t(value.size()));
+		buffer.insert(buffer.end(), value.begin(), value.end());
+		buffer.push_back(0);
+		return string_position;
+	}
+
+	/**
+	 * Sets the offset stored at a position to the target position, written after it.
+	 */
+	void patch_offset(size_t offset_position, size_t target_position) {
+		UTIL_REQUIRE(target_position > offset_position);
+		store(uint32_t(target_position - offset_position), offset_position);
+	}
+
+	/**
+	 * Pads the buffer so that its size is a multiple of the largest alignment.
+	 */
+	void end_root() {
+		align(sizeof(uint64_t));
+	}
+
+private:
+	static size_t align_size(size_t size, size_t alignment) {
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	void align(size_t alignment) {
+		buffer.resize(align_size(buffer.size(), alignment), 0);
+	}
+
+	// the elements following the length are aligned on their size
+	void align_vector(size_t element_size) {
+		size_t alignment = std::max(element_size, sizeof(uint32_t));
+		buffer.resize(align_size(buffer.size() + sizeof(uint32_t), alignment) - sizeof(uint32_t), 0);
+	}
+
+	template <class T> size_t write_scalar(T value) {
+		align(sizeof(T));
+		size_t position = buffer.size();
+		buffer.resize(position + sizeof(T));
+		store(value, position);
+		return position;
+	}
+
+	template <class T> void store(T value, size_t position) {
+		flatbuffer_table::store_little_endian(value, buffer.data() + position);
+	}
+};
+
+} // namespace util
+
+#endif /* FLATBUFFER_BUILDER_HPP_ */
@@ -0,0 +1,145 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef PROGRESS_MONITOR_HPP_
+#define PROGRESS_MONITOR_HPP_
+
+#include <chrono>
+#include <string>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+namespace util {
+
+/**
+ * Thrown by a progress monitor when its cancellation token is set.
+ */
+struct progress_cancelled : public std::runtime_error {
+
+	progress_cancelled(const std::string &stage) : std::runtime_error(stage + " cancelled") {}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reports the progress of the stages of a long running process and polls a cancellation token.
+ *
+ * A stage is started with its expected number of steps and each step is counted. Every interval steps, the
+ * cancellation token is polled and the callback is called with the stage name, the fraction of the steps done and the
+ * throughput in steps per second. A progress_cancelled exception is thrown when the token is set, the caller must
+ * release the partial results of the stage.
+ */
+class progress_monitor {
+
+	typedef std::chrono::steady_clock clock_type;
+
+public:
+	typedef std::function<void(const std::string &stage, double fraction, double throughput)> callback_type;
+	typedef std::function<bool()> cancellation_token_type;
+
+	static constexpr size_t default_max_interval = 1024;
+
+	progress_monitor() : max_interval(default_max_interval), size(0), done(0), interval(1), next(1) {}
+	progress_monitor(const callback_type &callback, const cancellation_token_type &cancellation_token, size_t max_interval = default_max_interval) : callback(callback), cancellation_token(cancellation_token), max_interval(std::max<size_t>(max_interval, 1)), size(0), done(0), interval(1), next(1) {}
+
+	void start(const std::string &stage, size_t size) {
+		this->stage = stage;
+		this->size = size;
+		done = 0;
+		interval = std::min(std::max<size_t>(size / 100, 1), max_interval);
+		start_time = clock_type::now();
+		report();
+	}
+
+	void step(size_t count = 1) {
+		done += count;
+		if(done >= next)
+			report();
+	}
+
+	void finish() {
+		done = std::max(done, size);
+		report();
+	}
+
+private:
+	callback_type callback;
+	cancellation_token_type cancellation_token;
+	size_t max_interval;
+	std::string stage;
+	size_t size;
+	size_t done;
+	size_t interval;
+	size_t next;
+	clock_type::time_point start_time;
+
+	void report() {
+		next = done + interval;
+		if(cancellation_token && cancellation_token())
+			throw progress_cancelled(stage);
+		if(callback)
+			callback(stage, get_fraction(), get_throughput());
+	}
+
+	double get_fraction() const {
+		return size == 0 ? 1 : std::min(double(done) / size, 1.0);
+	}
+
+	double get_throughput() const {
+		double seconds = std::chrono::duration<double>(clock_type::now() - start_time).count();
+		return seconds > 0 ? done / seconds : 0;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A progress monitor without callback nor cancellation, for the algorithms used outside of a process.
+ */
+struct null_progress {
+
+	void start(const std::string &, size_t) {}
+	void step(size_t = 1) {}
+	void finish() {}
+};
+
+} // namespace util
+
+#endif /* PROGRESS_MONITOR_HPP_ */
@@ -0,0 +1,70 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef PERMUTED_RANGE_HPP_
+#define PERMUTED_RANGE_HPP_
+
+#include <boost/range.hpp>
+#include <boost/iterator/permutation_iterator.hpp>
+
+namespace util {
+
+template <class Range, class IndexRange> struct permuted_range_traits {
+
+	typedef typename boost::range_iterator<Range>::type iterator_type;
+	typedef typename boost::range_iterator<const IndexRange>::type index_iterator_type;
+	typedef boost::permutation_iterator<iterator_type, index_iterator_type> permuted_iterator_type;
+	typedef boost::iterator_range<permuted_iterator_type> permuted_range_type;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns a view of the random access range visited in the order given by the indices.
+ */
+template <class Range, class IndexRange> inline typename permuted_range_traits<Range, IndexRange>::permuted_range_type make_permuted_range(Range &range, const IndexRange &indices) {
+	return boost::make_iterator_range(boost::make_permutation_iterator(boost::begin(range), boost::begin(indices)), boost::make_permutation_iterator(boost::begin(range), boost::end(indices)));
+}
+
+template <class Range, class IndexRange> inline typename permuted_range_traits<const Range, IndexRange>::permuted_range_type make_permuted_range(const Range &range, const IndexRange &indices) {
+	return boost::make_iterator_range(boost::make_permutation_iterator(boost::begin(range), boost::begin(indices)), boost::make_permutation_iterator(boost::begin(range), boost::end(indices)));
+}
+
+} // namespace util
+
+#endif /* PERMUTED_RANGE_HPP_ */
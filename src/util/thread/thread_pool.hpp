@@ -0,0 +1,171 @@
+/**
+ * GeoFIS R package
+ *
+ * Copyright (C) 2021 INRAE
+ *
+ * Authors:
+ * 	Jean-luc Lablée - INRAE
+ * 	Serge Guillaume - INRAE
+ *
+ * License: CeCILL v2.1
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-en.html
+ * 	https://cecill.info/licences/Licence_CeCILL_V2.1-fr.html
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "https://cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights, and the successive licensors have only limited liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <condition_variable>
+
+namespace util {
+
+/**
+ * Runs independent indexed tasks on a fixed number of threads, the calling thread being one of them.
+ *
+ * The threads take the next task index from a shared counter until all the tasks are done. The first exception
+ * thrown by a task stops the distribution of the remaining tasks and is rethrown by run once all the threads are
+ * done.
+ *
+ * The threads are started by the first run needing them and wait for the next run until the pool is destroyed, so a
+ * pool can be reused by successive runs without starting threads again. A pool is run by one thread at a time.
+ */
+class thread_pool {
+
+public:
+	thread_pool(size_t thread_count = default_thread_count()) : thread_count(std::max<size_t>(thread_count, 1)), generation(0), running_thread_count(0), stopping(false), work(nullptr) {}
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool &operator=(const thread_pool &) = delete;
+
+	~thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		work_condition.notify_all();
+		for(std::thread &thread : threads)
+			thread.join();
+	}
+
+	static size_t default_thread_count() {
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	size_t get_thread_count() const {
+		return thread_count;
+	}
+
+	template <class Task> void run(size_t task_count, const Task &task) {
+		std::atomic<size_t> next_task(0);
+		std::exception_ptr exception;
+		std::mutex exception_mutex;
+		std::function<void()> worker = [&]() {
+			for(size_t index = next_task++; index < task_count; index = next_task++) {
+				try {
+					task(index);
+				} catch(...) {
+					std::lock_guard<std::mutex> lock(exception_mutex);
+					if(!exception)
+						exception = std::current_exception();
+					next_task = task_count;
+				}
+			}
+		};
+		if(task_count > 1)
+			start_threads(std::min(thread_count, task_count) - 1);
+		if(task_count > 1 && !threads.empty()) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				work = &worker;
+				++generation;
+				running_thread_count = threads.size();
+			}
+			work_condition.notify_all();
+			worker();
+			std::unique_lock<std::mutex> lock(mutex);
+			done_condition.wait(lock, [this]() { return running_thread_count == 0; });
+			work = nullptr;
+		} else
+			worker();
+		if(exception)
+			std::rethrow_exception(exception);
+	}
+
+private:
+	void start_threads(size_t size) {
+		while(threads.size() < size) {
+			try {
+				threads.emplace_back(&thread_pool::wait_work, this, generation);
+			} catch(const std::system_error &) {
+				// the tasks are shared by the threads already started
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Every thread runs the work of each generation, the run waiting for all the threads to be done.
+	 */
+	void wait_work(size_t done_generation) {
+		std::unique_lock<std::mutex> lock(mutex);
+		for(;;) {
+			work_condition.wait(lock, [&]() { return stopping || generation != done_generation; });
+			if(stopping)
+				return;
+			done_generation = generation;
+			const std::function<void()> &generation_work = *work;
+			lock.unlock();
+			generation_work();
+			lock.lock();
+			if(--running_thread_count == 0)
+				done_condition.notify_one();
+		}
+	}
+
+	size_t thread_count;
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable work_condition;
+	std::condition_variable done_condition;
+	size_t generation;
+	size_t running_thread_count;
+	bool stopping;
+	const std::function<void()> *work;
+};
+
+} // namespace util
+
+#endif /* THREAD_POOL_HPP_ */
@@ -118,16 +118,30 @@ RCPP_MODULE(zoning_module) {
 	.constructor<S4>()
 	//.constructor<StringVector, NumericMatrix, NumericMatrix>()
 	.method("set_border", &zoning_wrapper::set_border)
+	.method("set_no_feature_binning", &zoning_wrapper::set_no_feature_binning)
+	.method("set_square_feature_binning", &zoning_wrapper::set_square_feature_binning)
+	.method("set_hexagonal_feature_binning", &zoning_wrapper::set_hexagonal_feature_binning)
+	.method("get_feature_bins", &zoning_wrapper::get_feature_bins)
+	.method("set_exact_voronoi_construction", &zoning_wrapper::set_exact_voronoi_construction)
+	.method("set_filtered_voronoi_construction", &zoning_wrapper::set_filtered_voronoi_construction)
+	.method("set_voronoi_tile_count", &zoning_wrapper::set_voronoi_tile_count)
 	.method("perform_voronoi", &zoning_wrapper::perform_voronoi)
 	.method("release_voronoi", &zoning_wrapper::release_voronoi)
 	.method("get_voronoi_map", &zoning_wrapper::get_voronoi_map)
+	.method("get_voronoi_sf", &zoning_wrapper::get_voronoi_sf)
 	.method("get_bounded_feature_size", &zoning_wrapper::get_bounded_feature_size)
+	.method("get_site_feature_size", &zoning_wrapper::get_site_feature_size)
 	.method("set_all_neighborhood", &zoning_wrapper::set_all_neighborhood)
 	.method("set_edge_length_neighborhood", &zoning_wrapper::set_edge_length_neighborhood)
 	.method("perform_neighborhood", &zoning_wrapper::perform_neighborhood)
 	.method("release_neighborhood", &zoning_wrapper::release_neighborhood)
 	.method("get_neighborhood_map", &zoning_wrapper::get_neighborhood_map)
+	.method("get_neighborhood_sf", &zoning_wrapper::get_neighborhood_sf)
 	.method("set_attribute_distances", &zoning_wrapper::set_attribute_distances)
+	.method("set_exact_fusion", &zoning_wrapper::set_exact_fusion)
+	.method("set_multilevel_fusion", &zoning_wrapper::set_multilevel_fusion)
+	.method("set_spanning_tree_fusion", &zoning_wrapper::set_spanning_tree_fusion)
+	.method("set_reciprocal_fusion", &zoning_wrapper::set_reciprocal_fusion)
 	.method("set_zone_distance", static_cast<void (zoning_wrapper::*)(const minimum<double> &)>(&zoning_wrapper::set_zone_distance), "set minimum zone distance", is_minimum_zone_distance)
 	.method("set_zone_distance", static_cast<void (zoning_wrapper::*)(const maximum<double> &)>(&zoning_wrapper::set_zone_distance), "set maximum zone distance", is_maximum_zone_distance)
 	.method("set_zone_distance", static_cast<void (zoning_wrapper::*)(const util::mean<double> &)>(&zoning_wrapper::set_zone_distance), "set mean zone distance", is_mean_zone_distance)
@@ -136,13 +150,33 @@ RCPP_MODULE(zoning_module) {
 	.method("perform_fusion", &zoning_wrapper::perform_fusion)
 	.method("release_fusion", &zoning_wrapper::release_fusion)
 	.method("get_fusion_size", &zoning_wrapper::get_fusion_size)
+	.method("get_cut_zone_size", &zoning_wrapper::get_cut_zone_size)
+	.method("get_fusion_dendrogram", &zoning_wrapper::get_fusion_dendrogram)
+	.method("perform_fusion_sweep", &zoning_wrapper::perform_fusion_sweep)
 	.method("set_merge", static_cast<void (zoning_wrapper::*)(const size_merge &)>(&zoning_wrapper::set_merge), "set size merge", is_size_merge)
 	.method("set_merge", static_cast<void (zoning_wrapper::*)(const area_merge &)>(&zoning_wrapper::set_merge), "set area merge", is_area_merge)
 	.method("perform_merge", &zoning_wrapper::perform_merge)
 	.method("release_merge", &zoning_wrapper::release_merge)
 	.method("get_merge_size", &zoning_wrapper::get_merge_size)
+	.method("set_zone_geometry_cache_budget", &zoning_wrapper::set_zone_geometry_cache_budget)
+	.method("get_zone_geometry_cache_statistics", &zoning_wrapper::get_zone_geometry_cache_statistics)
 	.method("get_merge_map", &zoning_wrapper::get_merge_map)
-	.method("get_merge_maps", &zoning_wrapper::get_merge_maps);
+	.method("get_merge_maps", &zoning_wrapper::get_merge_maps)
+	.method("get_merge_sf", &zoning_wrapper::get_merge_sf)
+	.method("get_merge_sfs", &zoning_wrapper::get_merge_sfs)
+	.method("get_zone_labels", &zoning_wrapper::get_zone_labels)
+	.method("get_zone_rasters", &zoning_wrapper::get_zone_rasters)
+	.method("get_quality_indices", &zoning_wrapper::get_quality_indices)
+	.method("write_merge_flatgeobuf", &zoning_wrapper::write_merge_flatgeobuf)
+	.method("save", &zoning_wrapper::save)
+	.method("load", &zoning_wrapper::load)
+	.method("set_progress", &zoning_wrapper::set_progress)
+	.method("perform_voronoi_async", &zoning_wrapper::perform_voronoi_async)
+	.method("perform_fusion_async", &zoning_wrapper::perform_fusion_async)
+	.method("is_task_done", &zoning_wrapper::is_task_done)
+	.method("get_task_progress", &zoning_wrapper::get_task_progress)
+	.method("wait_task", &zoning_wrapper::wait_task)
+	.method("cancel_task", &zoning_wrapper::cancel_task);
 
 	class_<minimum<double> >("minimum_wrapper")
 	.constructor();
@@ -38,6 +38,9 @@
  */
 #include <zoning_wrapper.h>
 #include <vector>
+#include <numeric>
+#include <chrono>
+#include <fstream>
 #include <boost/format.hpp>
 #include <boost/icl/closed_interval.hpp>
 #include <boost/icl/continuous_interval.hpp>
@@ -45,6 +48,7 @@
 #include <boost/range/algorithm/find_if.hpp>
 #include <rcpp/vector_range.hpp>
 #include <geofis/geometry/geometrical.hpp>
+#include <geofis/algorithm/zoning/fusion/fusion_dendrogram.hpp>
 #include <geofis/process/zoning/zoning_process.hpp>
 #include <geofis/rcpp/geometry/polygon_2.hpp>
 #include <geofis/rcpp/geometry/polygons.hpp>
@@ -52,6 +56,7 @@
 #include <geofis/rcpp/process/zoning/voronoi/voronoi_map.hpp>
 #include <geofis/rcpp/process/zoning/neighborhood/neighborhood_map.hpp>
 #include <geofis/rcpp/process/zoning/map.hpp>
+#include <geofis/io/flatgeobuf/flatgeobuf_map_writer.hpp>
 
 using namespace Rcpp;
 using namespace std;
@@ -71,6 +76,11 @@ typedef zoning_process_traits::kernel_type kernel_type;
 typedef zoning_process_traits::feature_type feature_type;
 typedef zoning_process_traits::attribute_distance_type attribute_distance_type;
 typedef zoning_process_traits::attribute_distance_container_type attribute_distance_container_type;
+typedef zoning_process_traits::aggregation_type aggregation_type;
+typedef zoning_process_traits::zone_distance_type zone_distance_type;
+typedef zoning_process_traits::multidimensional_distance_type multidimensional_distance_type;
+typedef zoning_process_traits::fusion_configuration_type fusion_configuration_type;
+typedef zoning_process_traits::fusion_configuration_container_type fusion_configuration_container_type;
 typedef zoning_process_traits::fusion_map_type fusion_map_type;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +89,12 @@ RCPP_EXPOSED_AS(euclidean_distance<double>)
 
 RCPP_EXPOSED_AS(minkowski_distance<double>)
 
+RCPP_EXPOSED_AS(minimum<double>)
+
+RCPP_EXPOSED_AS(maximum<double>)
+
+RCPP_EXPOSED_AS(util::mean<double>)
+
 RCPP_EXPOSED_AS(fuzzy_distance)
 
 struct attribute_distance_maker {
@@ -102,6 +118,40 @@ struct attribute_distance_maker {
 	}
 };
 
+struct zone_distance_maker {
+
+	typedef zone_distance_type result_type;
+
+	result_type operator()(SEXP sexp) const {
+		if(Rf_isS4(sexp)) {
+			S4 s4 = sexp;
+			if(s4.is("Rcpp_minimum_wrapper"))
+				return as<minimum<double> >(sexp);
+			else if(s4.is("Rcpp_maximum_wrapper"))
+				return as<maximum<double> >(sexp);
+			else if(s4.is("Rcpp_mean_wrapper"))
+				return as<util::mean<double> >(sexp);
+		}
+		stop("unsupported zone distance");
+	}
+};
+
+struct multidimensional_distance_maker {
+
+	typedef multidimensional_distance_type result_type;
+
+	result_type operator()(SEXP sexp) const {
+		if(Rf_isS4(sexp)) {
+			S4 s4 = sexp;
+			if(s4.is("Rcpp_euclidean_wrapper"))
+				return as<euclidean_distance<double> >(sexp);
+			else if(s4.is("Rcpp_minkowski_wrapper"))
+				return as<minkowski_distance<double> >(sexp);
+		}
+		stop("unsupported combine distance");
+	}
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct merge_checker : public static_visitor<void> {
@@ -121,16 +171,22 @@ struct merge_checker : public static_visitor<void> {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+static void check_user_interrupt(void *) {
+	R_CheckUserInterrupt();
+}
+
+// the user interrupt is checked out of the R error handling, so that the stages are released before returning to R
+static bool is_user_interrupt() {
+	return !R_ToplevelExec(check_user_interrupt, nullptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 zoning_wrapper::zoning_wrapper(S4 source) : source(source) {
 	NumericMatrix points = source.slot("coords");
 	DataFrame data_frame = wrap(source.slot("data"));
-	Function as_matrix("as.matrix");
-	NumericMatrix data = as_matrix(source.slot("data"));
-	Function row_names("rownames");
-	CharacterVector ids = row_names(data_frame);
-	auto feature_range = make_rcpp_feature_range<feature_type>(ids, points, data);
-	vector<feature_type> features(boost::begin(feature_range), boost::end(feature_range));
-	zp.reset(new zoning_process(features));
+	zp.reset(new zoning_process(make_rcpp_features<feature_type>(points, data_frame)));
+	zp->set_progress(progress_callback, is_user_interrupt);
 }
 
 zoning_wrapper::~zoning_wrapper() {}
@@ -139,49 +195,104 @@ void zoning_wrapper::set_border(S4 border) {
 	List polygons_list = border.slot("polygons");
 	S4 polygons = polygons_list[0];
 	List polygon_list = polygons.slot("Polygons");
-	zp->set_border(make_polygon_2<kernel_type>(polygon_list[0]));
+	get_process().set_border(make_polygon_2<kernel_type>(polygon_list[0]));
+}
+
+void zoning_wrapper::set_no_feature_binning() {
+	get_process().set_feature_binning(no_feature_binning());
+}
+
+void zoning_wrapper::set_square_feature_binning(double cell_size) {
+	get_process().set_feature_binning(square_feature_binning(cell_size));
+}
+
+void zoning_wrapper::set_hexagonal_feature_binning(double cell_size) {
+	get_process().set_feature_binning(hexagonal_feature_binning(cell_size));
+}
+
+DataFrame zoning_wrapper::get_feature_bins() const {
+	auto feature_bins = get_process().get_feature_bins();
+	CharacterVector ids(feature_bins.size());
+	CharacterVector bin_ids(feature_bins.size());
+	IntegerVector bin_sizes(feature_bins.size());
+	for(size_t index = 0; index < feature_bins.size(); ++index) {
+		ids[index] = feature_bins[index].id;
+		bin_ids[index] = feature_bins[index].bin_id;
+		bin_sizes[index] = feature_bins[index].bin_size;
+	}
+	return DataFrame::create(_["id"] = ids, _["bin"] = bin_ids, _["bin_size"] = bin_sizes, _["stringsAsFactors"] = false);
+}
+
+void zoning_wrapper::set_exact_voronoi_construction() {
+	get_process().set_voronoi_construction(exact_voronoi_construction());
+}
+
+void zoning_wrapper::set_filtered_voronoi_construction() {
+	get_process().set_voronoi_construction(filtered_voronoi_construction());
+}
+
+void zoning_wrapper::set_voronoi_tile_count(int voronoi_tile_count) {
+	get_process().set_voronoi_tile_count(voronoi_tile_count);
 }
 
 void zoning_wrapper::perform_voronoi() {
-	if(!zp->is_voronoi_implemented())
-		zp->compute_voronoi_process();
+	if(!get_process().is_voronoi_implemented())
+		get_process().compute_voronoi_process();
 }
 
 void zoning_wrapper::release_voronoi() {
-	zp->release_voronoi_process();
+	get_process().release_voronoi_process();
 }
 
 Nullable<S4> zoning_wrapper::get_voronoi_map() {
-	if(zp->is_voronoi_implemented())
-		return make_rcpp_voronoi_map(zp->get_voronoi_map(), source.slot("proj4string"));
+	if(get_process().is_voronoi_implemented())
+		return make_rcpp_voronoi_map(get_process().get_voronoi_map(), source.slot("proj4string"));
+	else
+		return R_NilValue;
+}
+
+Nullable<List> zoning_wrapper::get_voronoi_sf(List crs) {
+	if(get_process().is_voronoi_implemented())
+		return make_sf_voronoi_map(get_process().get_voronoi_map(), crs);
 	else
 		return R_NilValue;
 }
 
 size_t zoning_wrapper::get_bounded_feature_size() const {
-	return zp->get_bounded_feature_size();
+	return get_process().get_bounded_feature_size();
+}
+
+size_t zoning_wrapper::get_site_feature_size() const {
+	return get_process().get_site_feature_size();
 }
 
 void zoning_wrapper::set_all_neighborhood() {
-	zp->set_neighborhood(all_neighbors());
+	get_process().set_neighborhood(all_neighbors());
 }
 
 void zoning_wrapper::set_edge_length_neighborhood(double edge_length) {
-	zp->set_neighborhood(edge_length_neighborhood(edge_length));
+	get_process().set_neighborhood(edge_length_neighborhood(edge_length));
 }
 
 void zoning_wrapper::perform_neighborhood() {
-	if(!zp->is_neighborhood_implemented())
-		zp->compute_neighborhood_process();
+	if(!get_process().is_neighborhood_implemented())
+		get_process().compute_neighborhood_process();
 }
 
 void zoning_wrapper::release_neighborhood() {
-	zp->release_neighborhood_process();
+	get_process().release_neighborhood_process();
 }
 
 Nullable<Rcpp::S4> zoning_wrapper::get_neighborhood_map() {
-	if(zp->is_neighborhood_implemented())
-		return make_rcpp_neighborhood_map(zp->get_zone_neighbors(), zp->get_filtered_zone_neighbors(), source.slot("proj4string"));
+	if(get_process().is_neighborhood_implemented())
+		return make_rcpp_neighborhood_map(get_process().get_zone_neighbors(), get_process().get_filtered_zone_neighbors(), source.slot("proj4string"));
+	else
+		return R_NilValue;
+}
+
+Nullable<List> zoning_wrapper::get_neighborhood_sf(List crs) {
+	if(get_process().is_neighborhood_implemented())
+		return make_sf_neighborhood_map(get_process().get_zone_neighbors(), get_process().get_filtered_zone_neighbors(), crs);
 	else
 		return R_NilValue;
 }
@@ -189,41 +300,111 @@ Nullable<Rcpp::S4> zoning_wrapper::get_neighborhood_map() {
 void zoning_wrapper::set_attribute_distances(List attribute_distance_list) {
 	auto attribute_distance_range = make_vector_range(attribute_distance_list) | transformed(attribute_distance_maker());
 	attribute_distance_container_type attribute_distances(boost::begin(attribute_distance_range), boost::end(attribute_distance_range));
-	zp->set_attribute_distances(attribute_distances);
+	get_process().set_attribute_distances(attribute_distances);
+}
+
+void zoning_wrapper::set_exact_fusion() {
+	get_process().set_fusion_strategy(exact_fusion());
+}
+
+void zoning_wrapper::set_multilevel_fusion(int coarse_zone_size) {
+	get_process().set_fusion_strategy(multilevel_fusion(coarse_zone_size));
+}
+
+void zoning_wrapper::set_spanning_tree_fusion() {
+	get_process().set_fusion_strategy(spanning_tree_fusion());
+}
+
+void zoning_wrapper::set_reciprocal_fusion() {
+	get_process().set_fusion_strategy(reciprocal_fusion());
 }
 
 void zoning_wrapper::set_zone_distance(const maximum<double> &maximum_distance) {
-	zp->set_zone_distance(maximum_distance);
+	get_process().set_zone_distance(maximum_distance);
 }
 
 void zoning_wrapper::set_zone_distance(const minimum<double> &minimum_distance) {
-	zp->set_zone_distance(minimum_distance);
+	get_process().set_zone_distance(minimum_distance);
 }
 
 void zoning_wrapper::set_zone_distance(const util::mean<double> &mean_distance) {
-	zp->set_zone_distance(mean_distance);
+	get_process().set_zone_distance(mean_distance);
 }
 
 void zoning_wrapper::set_multidimensional_distance(const euclidean_distance<double> &euclidean_distance) {
-	zp->set_multidimensional_distance(euclidean_distance);
+	get_process().set_multidimensional_distance(euclidean_distance);
 }
 
 void zoning_wrapper::set_multidimensional_distance(const minkowski_distance<double> &minkowski_distance) {
-	zp->set_multidimensional_distance(minkowski_distance);
+	get_process().set_multidimensional_distance(minkowski_distance);
 }
 
 void zoning_wrapper::perform_fusion() {
-	if(!zp->is_fusion_implemented())
-		zp->compute_fusion_process();
+	if(!get_process().is_fusion_implemented())
+		get_process().compute_fusion_process();
 }
 
 void zoning_wrapper::release_fusion() {
-	zp->release_fusion_process();
+	get_process().release_fusion_process();
 }
 
 // must return int instead of size_t (return type of zp->get_fusion_size), otherwise NA_INTEGER is not handled as NA in R
 int zoning_wrapper::get_fusion_size () {
-	return zp->is_fusion_implemented() ? zp->get_fusion_size() : NA_INTEGER;
+	return get_process().is_fusion_implemented() ? get_process().get_fusion_size() : NA_INTEGER;
+}
+
+int zoning_wrapper::get_cut_zone_size(double distance) {
+	return get_process().is_fusion_implemented() ? get_process().get_cut_zone_size(distance) : NA_INTEGER;
+}
+
+/**
+ * The dendrogram is written directly in the R vectors of the hclust object, the leaves being the Voronoi polygons
+ * labelled by their ids.
+ */
+template <class DendrogramWriter> static List make_fusion_dendrogram(size_t fusion_size, const vector<string> &leaf_ids, DendrogramWriter write_dendrogram) {
+	size_t leaf_size = leaf_ids.size();
+	if(fusion_size + 1 != leaf_size)
+		stop("the fusion must merge all the zones into one zone to build a dendrogram");
+	IntegerMatrix merges(int(leaf_size - 1), 2);
+	NumericVector heights(leaf_size - 1);
+	IntegerVector order(leaf_size);
+	write_dendrogram(merges.begin(), heights.begin(), order.begin());
+	CharacterVector labels = wrap(leaf_ids);
+	List dendrogram = List::create(_["merge"] = merges, _["height"] = heights, _["order"] = order, _["labels"] = labels, _["method"] = "geofis");
+	dendrogram.attr("class") = "hclust";
+	return dendrogram;
+}
+
+Nullable<List> zoning_wrapper::get_fusion_dendrogram() {
+	if(get_process().is_fusion_implemented())
+		return make_fusion_dendrogram(get_process().get_fusion_size(), get_process().get_fusion_leaf_ids(), [this](int *merges, double *heights, int *order) { this->get_process().get_fusion_dendrogram(merges, heights, order); });
+	else
+		return R_NilValue;
+}
+
+/**
+ * Each configuration is a list with the attribute_distance, combine_distance and zone_distance of the zoning, the
+ * fusions are computed concurrently with the fusion strategy of the zoning and returned as dendrograms.
+ */
+List zoning_wrapper::perform_fusion_sweep(List configuration_list, int thread_count) {
+	if(thread_count < 0)
+		stop("threads must be a positive or zero integer value");
+	fusion_configuration_container_type fusion_configurations;
+	fusion_configurations.reserve(configuration_list.size());
+	for(List configuration : configuration_list) {
+		List attribute_distance_list = configuration["attribute_distance"];
+		auto attribute_distance_range = make_vector_range(attribute_distance_list) | transformed(attribute_distance_maker());
+		attribute_distance_container_type attribute_distances(boost::begin(attribute_distance_range), boost::end(attribute_distance_range));
+		fusion_configurations.push_back(fusion_configuration_type(aggregation_type(), zone_distance_maker()(configuration["zone_distance"]), multidimensional_distance_maker()(configuration["combine_distance"]), attribute_distances));
+	}
+	auto zone_fusion_sweep = get_process().compute_fusion_sweep(fusion_configurations, thread_count);
+	auto leaf_ids = get_process().get_fusion_leaf_ids();
+	List dendrograms(zone_fusion_sweep.size());
+	for(size_t index = 0; index < zone_fusion_sweep.size(); ++index) {
+		const auto &zone_fusion_steps = zone_fusion_sweep[index];
+		dendrograms[index] = make_fusion_dendrogram(zone_fusion_steps.size(), leaf_ids, [&](int *merges, double *heights, int *order) { write_fusion_dendrogram(leaf_ids.size(), zone_fusion_steps, merges, heights, order); });
+	}
+	return dendrograms;
 }
 
 void zoning_wrapper::check_size_merge(const size_merge &size_merge) const {
@@ -236,11 +417,11 @@ void zoning_wrapper::check_size_merge(const size_merge &size_merge) const {
 
 void zoning_wrapper::set_merge(const size_merge &size_merge) {
 	check_size_merge(size_merge);
-	zp->set_merge(size_merge);
+	get_process().set_merge(size_merge);
 }
 
 void zoning_wrapper::check_area_merge(const area_merge &area_merge) const {
-	polygon_type border = zp->get_border();
+	polygon_type border = get_process().get_border();
 	double max_area = CGAL::to_double(border.area());
 	auto area_interval = continuous_interval<double>::closed(0, max_area);
 	if(!contains(area_interval, area_merge.area))
@@ -249,7 +430,7 @@ void zoning_wrapper::check_area_merge(const area_merge &area_merge) const {
 
 void zoning_wrapper::set_merge(const area_merge &area_merge) {
 	check_area_merge(area_merge);
-	zp->set_merge(area_merge);
+	get_process().set_merge(area_merge);
 }
 
 void zoning_wrapper::check_merge(const merge_type &merge) const {
@@ -257,38 +438,347 @@ void zoning_wrapper::check_merge(const merge_type &merge) const {
 }
 
 void zoning_wrapper::perform_merge() {
-	if(!zp->is_merge_implemented()) {
-		check_merge(zp->get_merge());
-		zp->compute_merge_process();
+	if(!get_process().is_merge_implemented()) {
+		check_merge(get_process().get_merge());
+		get_process().compute_merge_process();
 	}
 }
 
 void zoning_wrapper::release_merge() {
-	zp->release_merge_process();
+	get_process().release_merge_process();
 }
 
 // must return int instead of size_t (return type of zp->get_merge_size), otherwise NA_INTEGER is not handled as NA in R
 int zoning_wrapper::get_merge_size() {
-	return zp->is_merge_implemented() ? zp->get_merge_size() : NA_INTEGER;
+	return get_process().is_merge_implemented() ? get_process().get_merge_size() : NA_INTEGER;
+}
+
+// the budget is a double, the number of bytes could exceed the range of an R integer
+void zoning_wrapper::set_zone_geometry_cache_budget(double budget) {
+	get_process().set_zone_geometry_cache_budget(size_t(budget));
 }
 
-Nullable<S4> zoning_wrapper::get_merge_map(size_t number_of_zones) {
-	if(zp->is_merge_implemented()) {
-		size_t merge_size = zp->get_merge_size();
-		closed_interval<size_t> merge_interval(1, merge_size);
-		if(!contains(merge_interval, number_of_zones))
-			stop(str(format("number_of_zones must be in range %1%") % merge_interval));
-		auto merge_map = zp->get_merge_map(number_of_zones - 1);
+NumericVector zoning_wrapper::get_zone_geometry_cache_statistics() {
+	const auto &geometry_cache = get_process().get_zone_geometry_cache();
+	return NumericVector::create(_["hits"] = geometry_cache.get_hit_size(), _["misses"] = geometry_cache.get_miss_size(), _["resident_bytes"] = geometry_cache.get_resident_bytes(), _["budget"] = geometry_cache.get_budget());
+}
+
+void zoning_wrapper::check_number_of_zones(size_t number_of_zones) const {
+	closed_interval<size_t> merge_interval(1, get_process().get_merge_size());
+	if(!contains(merge_interval, number_of_zones))
+		stop(str(format("number_of_zones must be in range %1%") % merge_interval));
+}
+
+void zoning_wrapper::check_tolerance(double tolerance) const {
+	if(!(tolerance >= 0))
+		stop("tolerance must be a positive or zero numeric value");
+}
+
+Nullable<S4> zoning_wrapper::get_merge_map(size_t number_of_zones, double tolerance) {
+	if(get_process().is_merge_implemented()) {
+		check_number_of_zones(number_of_zones);
+		check_tolerance(tolerance);
+		auto merge_map = get_process().get_merge_map(number_of_zones - 1, tolerance);
 		Function col_names("colnames");
 		return make_rcpp_map(merge_map, source.slot("proj4string"), col_names(source.slot("data")));
 	} else
 		return R_NilValue;
 }
 
-Nullable<List> zoning_wrapper::get_merge_maps(IntegerVector number_of_zones) {
-	if(zp->is_merge_implemented()) {
-		auto merge_map_range = number_of_zones | transformed([this](int n) { return this->get_merge_map(n); });
+Nullable<List> zoning_wrapper::get_merge_maps(IntegerVector number_of_zones, double tolerance) {
+	if(get_process().is_merge_implemented()) {
+		auto merge_map_range = number_of_zones | transformed([this, tolerance](int n) { return this->get_merge_map(n, tolerance); });
 		return List(boost::begin(merge_map_range), boost::end(merge_map_range));
 	} else
 		return R_NilValue;
 }
+
+Nullable<List> zoning_wrapper::get_merge_sf(size_t number_of_zones, List crs, double tolerance) {
+	if(get_process().is_merge_implemented()) {
+		check_number_of_zones(number_of_zones);
+		check_tolerance(tolerance);
+		auto merge_map = get_process().get_merge_map(number_of_zones - 1, tolerance);
+		Function col_names("colnames");
+		return make_sf_map(merge_map, crs, col_names(source.slot("data")));
+	} else
+		return R_NilValue;
+}
+
+Nullable<List> zoning_wrapper::get_merge_sfs(IntegerVector number_of_zones, List crs, double tolerance) {
+	if(get_process().is_merge_implemented()) {
+		auto merge_sf_range = number_of_zones | transformed([this, &crs, tolerance](int n) { return this->get_merge_sf(n, crs, tolerance); });
+		return List(boost::begin(merge_sf_range), boost::end(merge_sf_range));
+	} else
+		return R_NilValue;
+}
+
+/**
+ * The labels are the row indices of the zones in the maps, the data points outside the border being labelled NA.
+ */
+Nullable<IntegerMatrix> zoning_wrapper::get_zone_labels(IntegerVector number_of_zones) {
+	if(get_process().is_merge_implemented()) {
+		vector<size_t> map_indices;
+		map_indices.reserve(number_of_zones.size());
+		for(int n : number_of_zones) {
+			check_number_of_zones(n);
+			map_indices.push_back(n - 1);
+		}
+		NumericMatrix coords = source.slot("coords");
+		R_xlen_t size = coords.nrow();
+		const double *x = coords.begin();
+		const double *y = x + size;
+		vector<point_type> points;
+		points.reserve(size);
+		for(R_xlen_t row = 0; row < size; ++row)
+			points.push_back(point_type(x[row], y[row]));
+		auto labels = get_process().get_merge_map_labels(points, map_indices);
+		IntegerMatrix label_matrix(int(size), int(number_of_zones.size()));
+		for(size_t index = 0; index < labels.size(); ++index)
+			label_matrix[index] = labels[index] == 0 ? NA_INTEGER : int(labels[index]);
+		CharacterVector map_names(number_of_zones.size());
+		for(R_xlen_t index = 0; index < number_of_zones.size(); ++index)
+			map_names[index] = str(format("map%1%") % number_of_zones[index]);
+		colnames(label_matrix) = map_names;
+		return label_matrix;
+	} else
+		return R_NilValue;
+}
+
+/**
+ * The rasters cover the extent of the border, the origin attribute being the upper left corner of the grid, and the
+ * cells whose center is outside the border are NA.
+ */
+Nullable<List> zoning_wrapper::get_zone_rasters(IntegerVector number_of_zones, double cell_size) {
+	if(get_process().is_merge_implemented()) {
+		if(!(cell_size > 0))
+			stop("cell_size must be a positive numeric value");
+		vector<size_t> map_indices;
+		map_indices.reserve(number_of_zones.size());
+		for(int n : number_of_zones) {
+			check_number_of_zones(n);
+			map_indices.push_back(n - 1);
+		}
+		auto grid = get_process().get_raster_grid(cell_size);
+		auto labels = get_process().get_merge_map_rasters(grid, map_indices);
+		List rasters(number_of_zones.size());
+		CharacterVector map_names(number_of_zones.size());
+		for(R_xlen_t index = 0; index < number_of_zones.size(); ++index) {
+			IntegerMatrix raster(int(grid.row_size), int(grid.column_size));
+			auto map_labels = labels.begin() + index * grid.size();
+			transform(map_labels, map_labels + grid.size(), raster.begin(), [](uint32_t label) { return label == 0 ? NA_INTEGER : int(label); });
+			rasters[index] = raster;
+			map_names[index] = str(format("map%1%") % number_of_zones[index]);
+		}
+		rasters.attr("names") = map_names;
+		rasters.attr("origin") = NumericVector::create(grid.x_origin, grid.y_origin);
+		rasters.attr("cell_size") = cell_size;
+		return rasters;
+	} else
+		return R_NilValue;
+}
+
+Nullable<DataFrame> zoning_wrapper::get_quality_indices(bool merge, Nullable<IntegerVector> number_of_zones) {
+	if(merge ? get_process().is_merge_implemented() : get_process().is_fusion_implemented()) {
+		vector<zoning_quality> qualities;
+		if(merge) {
+			vector<size_t> map_indices;
+			if(number_of_zones.isNull()) {
+				map_indices.resize(get_process().get_merge_size());
+				std::iota(map_indices.begin(), map_indices.end(), size_t(0));
+			} else {
+				for(int n : IntegerVector(number_of_zones)) {
+					check_number_of_zones(n);
+					map_indices.push_back(n - 1);
+				}
+			}
+			qualities = get_process().get_merge_qualities(map_indices);
+		} else {
+			qualities = get_process().get_fusion_qualities();
+			if(number_of_zones.isNotNull()) {
+				closed_interval<size_t> fusion_interval(1, qualities.size());
+				vector<zoning_quality> selected_qualities;
+				for(int n : IntegerVector(number_of_zones)) {
+					if(!contains(fusion_interval, size_t(n)))
+						stop(str(format("number_of_zones must be in range %1%") % fusion_interval));
+					selected_qualities.push_back(qualities[n - 1]);
+				}
+				qualities.swap(selected_qualities);
+			}
+		}
+		Function col_names("colnames");
+		CharacterVector attribute_names = col_names(source.slot("data"));
+		R_xlen_t size = qualities.size();
+		IntegerVector zone_sizes(size);
+		NumericVector variance_reductions(size);
+		NumericVector relative_variances(size);
+		vector<NumericVector> attribute_variance_reductions, attribute_relative_variances;
+		for(R_xlen_t attribute = 0; attribute < attribute_names.size(); ++attribute) {
+			attribute_variance_reductions.push_back(NumericVector(size));
+			attribute_relative_variances.push_back(NumericVector(size));
+		}
+		for(R_xlen_t index = 0; index < size; ++index) {
+			zone_sizes[index] = qualities[index].zone_size;
+			variance_reductions[index] = qualities[index].get_variance_reduction();
+			relative_variances[index] = qualities[index].get_relative_variance();
+			for(R_xlen_t attribute = 0; attribute < attribute_names.size(); ++attribute) {
+				attribute_variance_reductions[attribute][index] = qualities[index].variance_reductions[attribute];
+				attribute_relative_variances[attribute][index] = qualities[index].relative_variances[attribute];
+			}
+		}
+		List columns = List::create(_["number_of_zones"] = zone_sizes, _["variance_reduction"] = variance_reductions, _["relative_variance"] = relative_variances);
+		for(R_xlen_t attribute = 0; attribute < attribute_names.size(); ++attribute) {
+			string attribute_name = as<string>(attribute_names[attribute]);
+			columns.push_back(attribute_variance_reductions[attribute], attribute_name + "_variance_reduction");
+			columns.push_back(attribute_relative_variances[attribute], attribute_name + "_relative_variance");
+		}
+		return DataFrame(columns);
+	} else
+		return R_NilValue;
+}
+
+/**
+ * Each map is computed and written zone by zone in its file before the next one, the coordinate reference system
+ * being written from the wkt of the sf crs object.
+ */
+void zoning_wrapper::write_merge_flatgeobuf(IntegerVector number_of_zones, CharacterVector paths, List crs, bool spatial_index) {
+	if(!get_process().is_merge_implemented())
+		stop("zoning must be performed before writing the maps");
+	if(paths.size() != number_of_zones.size())
+		stop("paths must have the length of number_of_zones");
+	for(int n : number_of_zones)
+		check_number_of_zones(n);
+	string crs_wkt;
+	if(crs.containsElementNamed("wkt")) {
+		CharacterVector wkt = crs["wkt"];
+		if(wkt.size() && wkt[0] != NA_STRING)
+			crs_wkt = as<string>(wkt[0]);
+	}
+	Function col_names("colnames");
+	vector<string> attribute_names = as<vector<string>>(col_names(source.slot("data")));
+	flatgeobuf_map_writer writer(attribute_names, crs_wkt, spatial_index);
+	for(R_xlen_t index = 0; index < number_of_zones.size(); ++index) {
+		string path = as<string>(paths[index]);
+		ofstream stream(path, ios::binary);
+		if(!stream)
+			stop(str(format("cannot open file %1%") % path));
+		writer.write(stream, get_process().get_merge_map(number_of_zones[index] - 1), str(format("map%1%") % number_of_zones[index]));
+		if(!stream)
+			stop(str(format("cannot write file %1%") % path));
+	}
+}
+
+void zoning_wrapper::save(string path, bool geometries) {
+	if(!get_process().is_fusion_implemented())
+		stop("zoning must be performed before save");
+	ofstream stream(path, ios::binary);
+	if(!stream)
+		stop(str(format("cannot open file %1%") % path));
+	get_process().save(stream, geometries);
+}
+
+void zoning_wrapper::load(string path) {
+	ifstream stream(path, ios::binary);
+	if(!stream)
+		stop(str(format("cannot open file %1%") % path));
+	get_process().load(stream);
+	perform_merge();
+}
+
+void zoning_wrapper::set_progress(Nullable<Function> callback) {
+	progress_callback = progress_callback_type();
+	if(callback.isNotNull()) {
+		Function function(callback.get());
+		progress_callback = [function](const string &stage, double fraction, double throughput) { function(stage, fraction, throughput); };
+	}
+	if(!task)
+		zp->set_progress(progress_callback, is_user_interrupt);
+}
+
+/**
+ * The zoning process is used by the wrapper once the background task is done, the R objects being only used on the
+ * main thread. The error of a finished task which was not waited for is reported by the first use of the process.
+ */
+zoning_process &zoning_wrapper::get_process() const {
+	if(task) {
+		if(!task->is_done())
+			stop("a zoning stage is running, wait for it or cancel it");
+		finish_task(true);
+	}
+	return *zp;
+}
+
+void zoning_wrapper::start_task(const std::function<void(zoning_process &)> &stages) {
+	get_process();
+	task.reset(new zoning_task(*zp, stages));
+}
+
+void zoning_wrapper::perform_voronoi_async() {
+	start_task([](zoning_process &process) {
+		if(!process.is_voronoi_implemented())
+			process.compute_voronoi_process();
+	});
+}
+
+void zoning_wrapper::perform_fusion_async() {
+	start_task([](zoning_process &process) {
+		if(!process.is_voronoi_implemented())
+			process.compute_voronoi_process();
+		if(!process.is_neighborhood_implemented())
+			process.compute_neighborhood_process();
+		if(!process.is_fusion_implemented())
+			process.compute_fusion_process();
+	});
+}
+
+bool zoning_wrapper::is_task_done() const {
+	return !task || task->is_done();
+}
+
+Nullable<List> zoning_wrapper::get_task_progress() const {
+	if(task) {
+		zoning_task_progress progress = task->get_progress();
+		return List::create(Named("stage") = progress.stage, Named("fraction") = progress.fraction, Named("throughput") = progress.throughput);
+	} else
+		return R_NilValue;
+}
+
+// the task is cancelled by a user interrupt while waiting
+void zoning_wrapper::wait_task() {
+	if(task) {
+		while(!task->wait_for(chrono::milliseconds(100))) {
+			try {
+				checkUserInterrupt();
+			} catch(...) {
+				task->cancel();
+				finish_task(false);
+				throw;
+			}
+		}
+		finish_task(true);
+	}
+}
+
+void zoning_wrapper::cancel_task() {
+	if(task) {
+		task->cancel();
+		finish_task(false);
+	}
+}
+
+/**
+ * Waits for the end of the task, restores the progress of the process and reports the error of the task. A stage
+ * interrupted by an error is released.
+ */
+void zoning_wrapper::finish_task(bool report_error) const {
+	std::unique_ptr<zoning_task> finished_task(std::move(task));
+	string error;
+	try {
+		finished_task->get();
+	} catch(const std::exception &exception) {
+		error = exception.what();
+	}
+	finished_task.reset();
+	zp->set_progress(progress_callback, is_user_interrupt);
+	if(report_error && !error.empty())
+		stop(error);
+}
@@ -40,16 +40,23 @@
 #define H90F4A34E_CFD8_491B_A582_852DCF44D0AE
 
 #include <Rcpp.h>
+#include <memory>
+#include <functional>
 #include <geofis/process/zoning/zoning_process.hpp>
+#include <geofis/process/zoning/zoning_task.hpp>
 
 struct merge_checker;
 
 class zoning_wrapper {
 
 	typedef typename geofis::zoning_process_traits::merge_type merge_type;
+	typedef typename geofis::zoning_process_traits::progress_callback_type progress_callback_type;
 
 	Rcpp::S4 source;
 	std::unique_ptr<geofis::zoning_process> zp;
+	progress_callback_type progress_callback;
+	// declared after the process, the task is ended before the process is destroyed
+	mutable std::unique_ptr<geofis::zoning_task> task;
 
 	zoning_wrapper() = delete;
 	zoning_wrapper(const zoning_wrapper &) = delete;
@@ -60,6 +67,12 @@ class zoning_wrapper {
 	void check_size_merge(const geofis::size_merge &size_merge) const;
 	void check_area_merge(const geofis::area_merge &area_merge) const;
 	void check_merge(const merge_type &merge) const;
+	void check_number_of_zones(size_t number_of_zones) const;
+	void check_tolerance(double tolerance) const;
+
+	geofis::zoning_process &get_process() const;
+	void start_task(const std::function<void(geofis::zoning_process &)> &stages);
+	void finish_task(bool report_error) const;
 
 	friend struct merge_checker;
 
@@ -69,12 +82,23 @@ public:
 
 	void set_border(Rcpp::S4 border);
 
+	void set_no_feature_binning();
+	void set_square_feature_binning(double cell_size);
+	void set_hexagonal_feature_binning(double cell_size);
+	Rcpp::DataFrame get_feature_bins() const;
+
+	void set_exact_voronoi_construction();
+	void set_filtered_voronoi_construction();
+	void set_voronoi_tile_count(int voronoi_tile_count);
+
 	void perform_voronoi();
 	void release_voronoi();
 
 	Rcpp::Nullable<Rcpp::S4> get_voronoi_map();
+	Rcpp::Nullable<Rcpp::List> get_voronoi_sf(Rcpp::List crs);
 
 	size_t get_bounded_feature_size() const;
+	size_t get_site_feature_size() const;
 
 	void set_all_neighborhood();
 	void set_edge_length_neighborhood(double edge_length);
@@ -83,9 +107,15 @@ public:
 	void release_neighborhood();
 
 	Rcpp::Nullable<Rcpp::S4> get_neighborhood_map();
+	Rcpp::Nullable<Rcpp::List> get_neighborhood_sf(Rcpp::List crs);
 
 	void set_attribute_distances(Rcpp::List attribute_distance_list);
 
+	void set_exact_fusion();
+	void set_multilevel_fusion(int coarse_zone_size);
+	void set_spanning_tree_fusion();
+	void set_reciprocal_fusion();
+
 	void set_zone_distance(const util::maximum<double> &maximum_distance);
 	void set_zone_distance(const util::minimum<double> &minimum_distance);
 	void set_zone_distance(const util::mean<double> &mean_distance);
@@ -97,6 +127,9 @@ public:
 	void release_fusion();
 
 	int get_fusion_size();
+	int get_cut_zone_size(double distance);
+	Rcpp::Nullable<Rcpp::List> get_fusion_dendrogram();
+	Rcpp::List perform_fusion_sweep(Rcpp::List configuration_list, int thread_count);
 
 	void set_merge(const geofis::size_merge &size_merge);
 	void set_merge(const geofis::area_merge &area_merge);
@@ -106,8 +139,29 @@ public:
 
 	int get_merge_size();
 
-	Rcpp::Nullable<Rcpp::S4> get_merge_map(size_t number_of_zones);
-	Rcpp::Nullable<Rcpp::List> get_merge_maps(Rcpp::IntegerVector number_of_zones);
+	void set_zone_geometry_cache_budget(double budget);
+	Rcpp::NumericVector get_zone_geometry_cache_statistics();
+
+	Rcpp::Nullable<Rcpp::S4> get_merge_map(size_t number_of_zones, double tolerance);
+	Rcpp::Nullable<Rcpp::List> get_merge_maps(Rcpp::IntegerVector number_of_zones, double tolerance);
+	Rcpp::Nullable<Rcpp::List> get_merge_sf(size_t number_of_zones, Rcpp::List crs, double tolerance);
+	Rcpp::Nullable<Rcpp::List> get_merge_sfs(Rcpp::IntegerVector number_of_zones, Rcpp::List crs, double tolerance);
+	Rcpp::Nullable<Rcpp::IntegerMatrix> get_zone_labels(Rcpp::IntegerVector number_of_zones);
+	Rcpp::Nullable<Rcpp::List> get_zone_rasters(Rcpp::IntegerVector number_of_zones, double cell_size);
+	Rcpp::Nullable<Rcpp::DataFrame> get_quality_indices(bool merge, Rcpp::Nullable<Rcpp::IntegerVector> number_of_zones);
+	void write_merge_flatgeobuf(Rcpp::IntegerVector number_of_zones, Rcpp::CharacterVector paths, Rcpp::List crs, bool spatial_index);
+
+	void save(std::string path, bool geometries);
+	void load(std::string path);
+
+	void set_progress(Rcpp::Nullable<Rcpp::Function> callback);
+
+	void perform_voronoi_async();
+	void perform_fusion_async();
+	bool is_task_done() const;
+	Rcpp::Nullable<Rcpp::List> get_task_progress() const;
+	void wait_task();
+	void cancel_task();
 };
 
 #endif // H90F4A34E_CFD8_491B_A582_852DCF44D0AE